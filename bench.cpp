@@ -0,0 +1,294 @@
+// Bench: search a fixed set of positions to a fixed depth and report how
+// the Lazy SMP search scales, without SFML.
+//
+//   bench [depth] [maxThreads] [hashMB] [--disable <feature>]...
+//   bench --movecheck
+//
+// Runs at 1, 2, 4, 8 ... threads up to maxThreads (default: all cores),
+// plus maxThreads itself, and prints time-to-depth, NPS and the speedup of
+// each over the single-threaded run. The single-threaded run also reports
+// how often a beta cutoff came from the first move, a measure of move
+// ordering quality. --disable switches off one selective search feature
+// (nullmove, lmr, rfp, futility, checkext) to measure what it is worth.
+//
+// --movecheck instead times a single "may this piece move there" check:
+// through the virtual per-piece classes the engine used before canReach
+// (kept here as the baseline), the Piece compatibility class and canReach.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "movegen.h"
+#include "notation.h"
+#include "piece.h"
+#include "search.h"
+
+namespace {
+
+const char* const POSITIONS[] = {
+    START_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r1bqkb1r/pp3ppp/2n1pn2/2pp4/3P4/2PBPN2/PP3PPP/RNBQK2R w KQkq - 0 6",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+struct BenchRun {
+    int threads;
+    int64_t timeMs;
+    uint64_t nodes;
+    uint64_t cutoffs;
+    uint64_t firstMoveCutoffs;
+};
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+// Search every position to the given depth from an empty table
+BenchRun run(int threads, int depth, size_t hashMB, const SearchFeatures& features) {
+    TranspositionTable tt(hashMB);
+    Search search(tt, threads);
+    search.setFeatures(features);
+
+    BenchRun total = { threads, 0, 0, 0, 0 };
+    for (const char* fen : POSITIONS) {
+        Game game;
+        game.loadFEN(fen);
+        tt.clear();
+
+        SearchLimits limits;
+        limits.depth = depth;
+        SearchResult result = search.think(game, limits);
+
+        total.timeMs += result.timeMs;
+        total.nodes += result.nodes;
+        total.cutoffs += result.cutoffs;
+        total.firstMoveCutoffs += result.firstMoveCutoffs;
+        if (threads == 1) {
+            std::cout << "  " << moveToString(result.bestMove) << " score " << result.score
+                      << " (" << result.nodes << " nodes, " << result.timeMs << " ms, "
+                      << std::fixed << std::setprecision(1) << percent(result.firstMoveCutoffs, result.cutoffs)
+                      << "% first-move cutoffs, " << percent(result.ttHits, result.ttProbes)
+                      << "% table hits)  " << fen << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+    return total;
+}
+
+// ============= BASELINE MOVE CHECK =============
+
+// The move check as it was before canReach: one class per piece kind and a
+// virtual isValidMove, reached through a table of shared objects
+class OldPiece {
+public:
+    explicit OldPiece(Color c) : color(c) {}
+    virtual ~OldPiece() = default;
+    virtual bool isValidMove(Position from, Position to, const Board& board) const = 0;
+
+protected:
+    Color color;
+
+    // Destination must be empty or hold an enemy piece
+    bool canLandOn(const Board& board, Position to) const {
+        PieceCode target = board.getPiece(to);
+        return target == NO_PIECE || colorOf(target) != color;
+    }
+};
+
+class OldPawn : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        int direction = (color == Color::WHITE) ? -1 : 1;
+        int startRow = (color == Color::WHITE) ? 6 : 1;
+        if (to.col == from.col && to.row == from.row + direction) return board.isEmpty(to);
+        if (to.col == from.col && from.row == startRow && to.row == from.row + 2 * direction) {
+            return board.isEmpty(to) && board.isEmpty(Position(from.row + direction, from.col));
+        }
+        if (std::abs(to.col - from.col) == 1 && to.row == from.row + direction) {
+            PieceCode target = board.getPiece(to);
+            return target != NO_PIECE && colorOf(target) != color;
+        }
+        return false;
+    }
+};
+
+class OldRook : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        if (!(Attacks::rook(toSquare(from), board.pieces()) & squareBB(toSquare(to)))) return false;
+        return canLandOn(board, to);
+    }
+};
+
+class OldKnight : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        int rowDiff = std::abs(to.row - from.row);
+        int colDiff = std::abs(to.col - from.col);
+        if (!((rowDiff == 2 && colDiff == 1) || (rowDiff == 1 && colDiff == 2))) return false;
+        return canLandOn(board, to);
+    }
+};
+
+class OldBishop : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        if (!(Attacks::bishop(toSquare(from), board.pieces()) & squareBB(toSquare(to)))) return false;
+        return canLandOn(board, to);
+    }
+};
+
+class OldQueen : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        if (!(Attacks::queen(toSquare(from), board.pieces()) & squareBB(toSquare(to)))) return false;
+        return canLandOn(board, to);
+    }
+};
+
+class OldKing : public OldPiece {
+public:
+    using OldPiece::OldPiece;
+    bool isValidMove(Position from, Position to, const Board& board) const override {
+        if (std::abs(to.row - from.row) > 1 || std::abs(to.col - from.col) > 1) return false;
+        return canLandOn(board, to);
+    }
+};
+
+const OldPiece& oldPieceFor(PieceCode piece) {
+    static const OldPawn whitePawn(Color::WHITE), blackPawn(Color::BLACK);
+    static const OldRook whiteRook(Color::WHITE), blackRook(Color::BLACK);
+    static const OldKnight whiteKnight(Color::WHITE), blackKnight(Color::BLACK);
+    static const OldBishop whiteBishop(Color::WHITE), blackBishop(Color::BLACK);
+    static const OldQueen whiteQueen(Color::WHITE), blackQueen(Color::BLACK);
+    static const OldKing whiteKing(Color::WHITE), blackKing(Color::BLACK);
+
+    static const OldPiece* const table[12] = {
+        &whitePawn, &whiteRook, &whiteKnight, &whiteBishop, &whiteQueen, &whiteKing,
+        &blackPawn, &blackRook, &blackKnight, &blackBishop, &blackQueen, &blackKing
+    };
+    return *table[piece];
+}
+
+// One piece on its square and a target square anywhere on the board
+struct MoveCheck {
+    const Board* board;
+    PieceCode piece;
+    int from, to;
+    Position fromPos, toPos;
+};
+
+// Time the same checks through each interface, several rounds each
+void benchMoveChecks() {
+    const int ROUNDS = 2000;
+
+    std::vector<Game> games;
+    for (const char* fen : POSITIONS) {
+        games.emplace_back();
+        games.back().loadFEN(fen);
+    }
+
+    std::vector<MoveCheck> checks;
+    for (const Game& game : games) {
+        const Board& board = game.getBoard();
+        for (int from = 0; from < 64; from++) {
+            PieceCode piece = board.pieceOn(from);
+            if (piece == NO_PIECE) continue;
+            for (int to = 0; to < 64; to++) {
+                checks.push_back({ &board, piece, from, to, toPosition(from), toPosition(to) });
+            }
+        }
+    }
+
+    auto time = [&](auto check) {
+        auto start = std::chrono::steady_clock::now();
+        long valid = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (const MoveCheck& c : checks) valid += check(c);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(2) << ns / (double(ROUNDS) * checks.size())
+                  << " ns per check (" << valid / ROUNDS << " of " << checks.size() << " valid)\n";
+        std::cout.unsetf(std::ios::fixed);
+    };
+
+    std::cout << "old virtual check:  ";
+    time([](const MoveCheck& c) { return oldPieceFor(c.piece).isValidMove(c.fromPos, c.toPos, *c.board); });
+    std::cout << "Piece::isValidMove: ";
+    time([](const MoveCheck& c) {
+        return Piece::forCode(c.piece).isValidMove(c.fromPos, c.toPos, const_cast<Board&>(*c.board));
+    });
+    std::cout << "canReach:           ";
+    time([](const MoveCheck& c) { return canReach(*c.board, c.piece, c.from, c.to); });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SearchFeatures features;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--movecheck") {
+            benchMoveChecks();
+            return 0;
+        } else if (arg == "--disable" && i + 1 < argc) {
+            if (!features.set(argv[++i], false)) {
+                std::cerr << "Unknown search feature: " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    int depth = (positional.size() > 0) ? std::atoi(positional[0].c_str()) : 10;
+    int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    int maxThreads = (positional.size() > 1) ? std::max(1, std::atoi(positional[1].c_str())) : hardwareThreads;
+    size_t hashMB = (positional.size() > 2) ? std::strtoul(positional[2].c_str(), nullptr, 10) : 64;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "Depth " << depth << ", " << hashMB << " MB hash, "
+              << hardwareThreads << " hardware threads\n";
+
+    std::vector<BenchRun> runs;
+    for (int threads : threadCounts) {
+        if (threads == 1) std::cout << "Single-threaded results:\n";
+        runs.push_back(run(threads, depth, hashMB, features));
+    }
+
+    const BenchRun& base = runs.front();
+    std::cout << "First-move cutoff rate: " << std::fixed << std::setprecision(1)
+              << percent(base.firstMoveCutoffs, base.cutoffs) << "% of " << base.cutoffs << " cutoffs\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << "\n" << std::setw(8) << "threads" << std::setw(12) << "time ms" << std::setw(14) << "nodes"
+              << std::setw(12) << "knps" << std::setw(14) << "ttd speedup" << std::setw(14) << "nps speedup\n";
+    for (const BenchRun& r : runs) {
+        double nps = r.nodes * 1000.0 / std::max<int64_t>(r.timeMs, 1);
+        double baseNps = base.nodes * 1000.0 / std::max<int64_t>(base.timeMs, 1);
+        std::cout << std::setw(8) << r.threads << std::setw(12) << r.timeMs << std::setw(14) << r.nodes
+                  << std::setw(12) << static_cast<uint64_t>(nps / 1000) << std::fixed << std::setprecision(2)
+                  << std::setw(14) << static_cast<double>(base.timeMs) / std::max<int64_t>(r.timeMs, 1)
+                  << std::setw(13) << nps / baseNps << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include "bitbase.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "search.h"
+
+namespace {
+
+const char MAGIC[8] = { 'C', 'H', 'E', 'S', 'S', 'B', 'B', '1' };
+
+// Pieces in the order table names list them, strongest first
+const char NAME_LETTERS[] = "QRBNP";
+const PieceType NAME_ORDER[] = { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT, PieceType::PAWN };
+
+// Squares of the a1-d1-d4 triangle, and each square's place in it (-1 outside)
+const int TRIANGLE_SQUARES[10] = { 0, 1, 2, 3, 9, 10, 11, 18, 19, 27 };
+
+constexpr std::array<int, 64> makeTriangleIndex() {
+    std::array<int, 64> t {};
+    for (int sq = 0; sq < 64; sq++) t[sq] = -1;
+    for (int i = 0; i < 10; i++) t[TRIANGLE_SQUARES[i]] = i;
+    return t;
+}
+
+constexpr std::array<int, 64> TRIANGLE_INDEX = makeTriangleIndex();
+
+// One of the eight board symmetries: bit 2 swaps files and ranks, bit 0
+// mirrors the files and bit 1 the ranks
+int transform(int sq, int t) {
+    int file = fileOf(sq), rank = rankOf(sq);
+    if (t & 4) std::swap(file, rank);
+    if (t & 1) file = 7 - file;
+    if (t & 2) rank = 7 - rank;
+    return squareOf(rank, file);
+}
+
+PieceCode flipColor(PieceCode piece) {
+    return static_cast<PieceCode>((piece + 6) % 12);
+}
+
+} // namespace
+
+// ============= LAYOUT =============
+
+uint32_t materialKeyOf(const PieceCode* pieces, int count) {
+    uint32_t key = 0;
+    for (int i = 0; i < count; i++) {
+        if (typeOf(pieces[i]) == PieceType::KING) continue;
+        key += 1u << (3 * (toIndex(colorOf(pieces[i])) * 5 + toIndex(typeOf(pieces[i]))));
+    }
+    return key;
+}
+
+BitbaseLayout::BitbaseLayout(const std::string& tableName)
+    : pawns(false), kingPairs(0), half(0), name(tableName), count(0), materialKey(0), size(0) {
+    size_t split = name.find('v');
+    if (split == std::string::npos || name.size() < 4 || name[0] != 'K' || name[split + 1] != 'K') return;
+
+    int men = 2;
+    PieceCode parsed[Bitbase::MAX_MEN] = { makePiece(Color::WHITE, PieceType::KING), makePiece(Color::BLACK, PieceType::KING) };
+    for (size_t i = 1; i < name.size(); i++) {
+        if (i == split || i == split + 1) continue;
+        const char* letter = std::strchr(NAME_LETTERS, name[i]);
+        if (!letter || !*letter || men == Bitbase::MAX_MEN) return;
+        Color color = (i < split) ? Color::WHITE : Color::BLACK;
+        PieceType type = NAME_ORDER[letter - NAME_LETTERS];
+        parsed[men++] = makePiece(color, type);
+        pawns |= type == PieceType::PAWN;
+    }
+    if (men < 3) return;
+
+    count = men;
+    std::copy(parsed, parsed + men, pieces);
+    materialKey = materialKeyOf(pieces, count);
+    kingPairs = (pawns ? 32 : 10) * 64;
+    half = kingPairs;
+    for (int i = 2; i < count; i++) half *= 64;
+    size = 2 * half;
+}
+
+size_t BitbaseLayout::index(const int* squares, Color sideToMove) const {
+    size_t best = size;
+    for (int t = 0; t < (pawns ? 2 : 8); t++) {
+        int s[Bitbase::MAX_MEN];
+        for (int i = 0; i < count; i++) s[i] = transform(squares[i], t);
+        if (pawns ? fileOf(s[0]) > 3 : TRIANGLE_INDEX[s[0]] < 0) continue;
+
+        // Identical men are listed in ascending square order
+        for (int i = 2; i + 1 < count; i++) {
+            if (pieces[i] == pieces[i + 1] && s[i] > s[i + 1]) std::swap(s[i], s[i + 1]);
+        }
+
+        size_t idx = pawns ? rankOf(s[0]) * 4 + fileOf(s[0]) : TRIANGLE_INDEX[s[0]];
+        for (int i = 1; i < count; i++) idx = idx * 64 + s[i];
+        best = std::min(best, idx);
+    }
+    return (sideToMove == Color::BLACK ? half : 0) + best;
+}
+
+bool BitbaseLayout::decode(size_t index, int* squares, Color& sideToMove) const {
+    sideToMove = (index >= half) ? Color::BLACK : Color::WHITE;
+    size_t rest = index % half;
+    for (int i = count - 1; i >= 1; i--) {
+        squares[i] = static_cast<int>(rest % 64);
+        rest /= 64;
+    }
+    squares[0] = pawns ? squareOf(static_cast<int>(rest / 4), static_cast<int>(rest % 4)) : TRIANGLE_SQUARES[rest];
+    return this->index(squares, sideToMove) == index;
+}
+
+// Materials by number of men, then by number of pawns, since a capture
+// leads to fewer men and a promotion to one pawn fewer
+std::vector<std::string> bitbaseNames() {
+    struct Named {
+        int men;
+        int pawns;
+        std::string name;
+    };
+    std::vector<Named> names;
+
+    // Up to two extra men, as indices into NAME_LETTERS (-1 for none) and
+    // strongest first on each side; the stronger side is White
+    for (int w1 = 0; w1 < 5; w1++) {
+        for (int w2 = -1; w2 < 5; w2++) {
+            for (int b1 = -1; b1 < 5; b1++) {
+                if (w2 >= 0 && (w2 < w1 || b1 >= 0)) continue;
+                if (w2 < 0 && b1 >= 0 && b1 < w1) continue;
+
+                std::string name = "K";
+                name += NAME_LETTERS[w1];
+                if (w2 >= 0) name += NAME_LETTERS[w2];
+                name += "vK";
+                if (b1 >= 0) name += NAME_LETTERS[b1];
+
+                int pawns = (w1 == 4) + (w2 == 4) + (b1 == 4);
+                names.push_back({ 3 + (w2 >= 0) + (b1 >= 0), pawns, name });
+            }
+        }
+    }
+    std::stable_sort(names.begin(), names.end(), [](const Named& a, const Named& b) {
+        return a.men != b.men ? a.men < b.men : a.pawns < b.pawns;
+    });
+
+    std::vector<std::string> result;
+    for (const Named& n : names) result.push_back(n.name);
+    return result;
+}
+
+// ============= PROBING =============
+
+bool EndgameMen::fromGame(const Game& game) {
+    const Board& board = game.getBoard();
+    Bitboard occupied = board.pieces();
+    if (popCount(occupied) > Bitbase::MAX_MEN || game.getCastlingRights() || game.getEpSquare() != NO_SQUARE) {
+        return false;
+    }
+    count = 0;
+    while (occupied) {
+        int sq = popLsb(occupied);
+        pieces[count] = board.pieceOn(sq);
+        squares[count++] = sq;
+    }
+    sideToMove = game.getCurrentPlayer();
+    return true;
+}
+
+EndgameMen menAfter(const EndgameMen& men, Move move) {
+    EndgameMen after = men;
+    int captured = (move.type() == MoveType::EN_PASSANT) ? (move.to() ^ 8) : move.to();
+    for (int i = 0; i < after.count; i++) {
+        if (after.squares[i] == captured && move.type() != MoveType::CASTLING) {
+            after.pieces[i] = after.pieces[after.count - 1];
+            after.squares[i] = after.squares[after.count - 1];
+            after.count--;
+            break;
+        }
+    }
+    for (int i = 0; i < after.count; i++) {
+        if (after.squares[i] != move.from()) continue;
+        after.squares[i] = move.to();
+        if (move.type() == MoveType::PROMOTION) after.pieces[i] = makePiece(colorOf(after.pieces[i]), move.promotion());
+        break;
+    }
+    after.sideToMove = ~men.sideToMove;
+    return after;
+}
+
+bool allowsEnPassant(Game& game, Move move) {
+    const Board& board = game.getBoard();
+    Color us = game.getCurrentPlayer();
+    if ((move.to() ^ move.from()) != 16 || board.pieceOn(move.from()) != makePiece(us, PieceType::PAWN)) return false;
+    if (!(Attacks::pawn(us, (move.from() + move.to()) / 2) & board.pieces(~us, PieceType::PAWN))) return false;
+
+    // The capture may still be illegal, e.g. with the capturing pawn pinned
+    game.makeMove(move);
+    MoveList replies;
+    generateMoves(game, replies);
+    game.undoMove();
+    return std::any_of(replies.begin(), replies.end(), [](const Move& reply) {
+        return reply.type() == MoveType::EN_PASSANT;
+    });
+}
+
+void writeBitbaseHeader(unsigned char* out, uint64_t entries) {
+    std::memcpy(out, MAGIC, sizeof(MAGIC));
+    for (int i = 0; i < 8; i++) out[8 + i] = static_cast<unsigned char>(entries >> (8 * i));
+}
+
+const Bitbases::Table* Bitbases::find(uint32_t key) const {
+    auto it = std::lower_bound(tables.begin(), tables.end(), key, [](const Table& t, uint32_t k) {
+        return t.layout.materialKey < k;
+    });
+    return (it != tables.end() && it->layout.materialKey == key) ? &*it : nullptr;
+}
+
+bool Bitbases::add(const std::string& directory, const std::string& name) {
+    BitbaseLayout layout(name);
+    if (!layout.count || find(layout.materialKey)) return false;
+
+    std::unique_ptr<MappedFile> file(new MappedFile(directory + "/" + name + ".bb", MappedFile::Access::RANDOM));
+    uint64_t entries = 0;
+    if (file->size() >= HEADER_SIZE) {
+        for (int i = 7; i >= 0; i--) entries = (entries << 8) | file->data()[8 + i];
+    }
+    if (!file->isOpen() || file->size() != HEADER_SIZE + layout.size || entries != layout.size
+        || std::memcmp(file->data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    Table table = { layout, std::move(file) };
+    auto at = std::lower_bound(tables.begin(), tables.end(), layout.materialKey, [](const Table& t, uint32_t k) {
+        return t.layout.materialKey < k;
+    });
+    tables.insert(at, std::move(table));
+    return true;
+}
+
+int Bitbases::load(const std::string& directory) {
+    int loaded = 0;
+    for (const std::string& name : bitbaseNames()) loaded += add(directory, name);
+    return loaded;
+}
+
+bool Bitbases::probe(const EndgameMen& men, uint8_t& entry) const {
+    if (men.count == 2) {
+        entry = 0;
+        return true;
+    }
+
+    // Find the table as the men stand, or with the colors swapped
+    bool flip = false;
+    const Table* table = find(materialKeyOf(men.pieces, men.count));
+    if (!table) {
+        PieceCode flipped[Bitbase::MAX_MEN];
+        for (int i = 0; i < men.count; i++) flipped[i] = flipColor(men.pieces[i]);
+        table = find(materialKeyOf(flipped, men.count));
+        flip = true;
+    }
+    if (!table) return false;
+
+    // Put the squares in the table's order of men
+    const BitbaseLayout& layout = table->layout;
+    int squares[Bitbase::MAX_MEN];
+    bool used[Bitbase::MAX_MEN] = {};
+    for (int slot = 0; slot < layout.count; slot++) {
+        for (int i = 0; i < men.count; i++) {
+            PieceCode piece = flip ? flipColor(men.pieces[i]) : men.pieces[i];
+            if (!used[i] && piece == layout.pieces[slot]) {
+                used[i] = true;
+                squares[slot] = flip ? men.squares[i] ^ 56 : men.squares[i];
+                break;
+            }
+        }
+    }
+    Color toMove = flip ? ~men.sideToMove : men.sideToMove;
+    entry = table->file->data()[HEADER_SIZE + layout.index(squares, toMove)];
+    return true;
+}
+
+bool Bitbases::probeEnPassant(Game& game, Move move, uint8_t& entry) const {
+    if (!allowsEnPassant(game, move)) return false;
+
+    game.makeMove(move);
+    MoveList replies;
+    generateMoves(game, replies);
+    bool covered = true;
+    entry = 0;
+    bool first = true;
+    for (const Move& reply : replies) {
+        if (reply.type() != MoveType::EN_PASSANT) continue;
+        game.makeMove(reply);
+        EndgameMen men;
+        uint8_t child;
+        if (men.fromGame(game) && probe(men, child)) {
+            entry = first ? Bitbase::entryBefore(child) : Bitbase::preferred(entry, Bitbase::entryBefore(child));
+            first = false;
+        } else {
+            covered = false;
+        }
+        game.undoMove();
+    }
+    game.undoMove();
+    return covered;
+}
+
+bool Bitbases::probeScore(const Game& game, int ply, int& score) const {
+    EndgameMen men;
+    uint8_t entry;
+    if (tables.empty() || !men.fromGame(game) || !probe(men, entry)) return false;
+
+    int plies = Bitbase::pliesOf(entry);
+    score = Bitbase::isWin(entry) ? MATE_SCORE - ply - plies
+          : Bitbase::isLoss(entry) ? -(MATE_SCORE - ply - plies)
+          : 0;
+    return true;
+}
+
+Move Bitbases::bestMove(const Game& game, int& score) const {
+    EndgameMen men;
+    if (tables.empty() || !men.fromGame(game)) return Move();
+
+    MoveList moves;
+    generateMoves(game, moves);
+    Game scratch = game;
+
+    // Rank every move: wins by fewest plies, then draws, then losses by most
+    Move best;
+    int bestRank = 0;
+    for (const Move& move : moves) {
+        uint8_t entry;
+        if (!probe(menAfter(men, move), entry)) return Move();
+        if (allowsEnPassant(scratch, move)) {
+            uint8_t capture;
+            if (!probeEnPassant(scratch, move, capture)) return Move();
+            entry = Bitbase::preferred(entry, capture);
+        }
+
+        int plies = Bitbase::pliesOf(entry) + 1;
+        int rank = Bitbase::isLoss(entry) ? 2000 - plies : Bitbase::isWin(entry) ? plies - 2000 : 0;
+        if (best == Move() || rank > bestRank) {
+            best = move;
+            bestRank = rank;
+            score = Bitbase::isLoss(entry) ? MATE_SCORE - plies : Bitbase::isWin(entry) ? -(MATE_SCORE - plies) : 0;
+        }
+    }
+    return best;
+}
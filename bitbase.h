@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "mappedfile.h"
+#include "movegen.h"
+
+// ============= ENDGAME BITBASES =============
+//
+// Tables for every ending of up to four men, one file per material such as
+// "KRvKN.bb", written by bitbasegen. A table holds one byte per position:
+// 0 for a draw (or no such position), otherwise the number of plies to
+// mate plus one. The side to move wins when that distance is odd and is
+// mated when it is even. A win/draw/loss bit alone could not tell which
+// winning move makes progress, so the distance is kept.
+//
+// The stronger side of a table is White. Pawnless tables are reduced by
+// the eight symmetries of the board, with the white king in the a1-d1-d4
+// triangle; tables with pawns by the left-right mirror, with the white
+// king on files a-d. Entries hold no en passant square, so positions with
+// one or with castling rights are never probed; a double pawn push that
+// allows an en passant capture is scored from the entry after it and the
+// captures, like a move that leaves the table.
+
+namespace Bitbase {
+
+const int MAX_MEN = 4;
+
+// Entry for a mate in the given number of plies (0 = mated now)
+inline uint8_t entryFor(int plies) { return static_cast<uint8_t>(plies + 1); }
+inline int pliesOf(uint8_t entry) { return entry - 1; }
+inline bool isWin(uint8_t entry) { return entry != 0 && (entry - 1) % 2 == 1; }
+inline bool isLoss(uint8_t entry) { return entry != 0 && (entry - 1) % 2 == 0; }
+
+// Entry of a position from the view of the side that moved into it
+inline uint8_t entryBefore(uint8_t entry) { return entry == 0 ? 0 : static_cast<uint8_t>(entry + 1); }
+
+// Of two entries for the same side, the one it prefers: the fastest win,
+// then a draw, then the slowest loss
+inline uint8_t preferred(uint8_t a, uint8_t b) {
+    auto rank = [](uint8_t entry) { return isWin(entry) ? 1000 - entry : isLoss(entry) ? entry - 1000 : 0; };
+    return rank(a) >= rank(b) ? a : b;
+}
+
+} // namespace Bitbase
+
+// Up to four men and the side to move
+struct EndgameMen {
+    int count;
+    PieceCode pieces[Bitbase::MAX_MEN];
+    int squares[Bitbase::MAX_MEN];
+    Color sideToMove;
+
+    // The men of a position; false if it has more than four or any
+    // castling rights or en passant square
+    bool fromGame(const Game& game);
+};
+
+// Index layout of one material's table
+class BitbaseLayout {
+private:
+    bool pawns;
+    size_t kingPairs;    // white king squares in the reduced region times 64
+    size_t half;         // positions per side to move
+
+public:
+    std::string name;
+    int count;
+    PieceCode pieces[Bitbase::MAX_MEN];   // kings, then White's and Black's other men
+    uint32_t materialKey;
+    size_t size;
+
+    // Layout for a name such as "KQvK" or "KRPvKB"; count is 0 if invalid
+    explicit BitbaseLayout(const std::string& tableName);
+
+    // Canonical index of the men, with squares given in pieces[] order
+    size_t index(const int* squares, Color sideToMove) const;
+
+    // Squares and side to move of an index; false unless the index is the
+    // canonical one for its position (the others are unused)
+    bool decode(size_t index, int* squares, Color& sideToMove) const;
+};
+
+// Material key of a set of men: a count per color and piece type
+uint32_t materialKeyOf(const PieceCode* pieces, int count);
+
+// Every table name up to four men, each after the tables it depends on
+std::vector<std::string> bitbaseNames();
+
+// Memory-mapped tables and probing by position
+class Bitbases {
+private:
+    struct Table {
+        BitbaseLayout layout;
+        std::unique_ptr<MappedFile> file;
+    };
+    std::vector<Table> tables;   // sorted by material key
+
+    const Table* find(uint32_t key) const;
+
+public:
+    static const size_t HEADER_SIZE = 16;
+
+    // Map the table file of the given name from a directory; false if it
+    // is missing or does not match the layout
+    bool add(const std::string& directory, const std::string& name);
+
+    // Map every table found in a directory; returns how many
+    int load(const std::string& directory);
+
+    size_t size() const { return tables.size(); }
+
+    // Entry for a position from the side to move's view; false if no table
+    // covers its material. Two bare kings are a draw.
+    bool probe(const EndgameMen& men, uint8_t& entry) const;
+
+    // Best entry the en passant captures after a legal move give the
+    // capturing side; false if the move is no double pawn push allowing
+    // one, or a table is missing (see allowsEnPassant)
+    bool probeEnPassant(Game& game, Move move, uint8_t& entry) const;
+
+    // Search score of a position at the given ply; false if not covered
+    bool probeScore(const Game& game, int ply, int& score) const;
+
+    // The fastest mate, else a drawing move, else the longest defence, with
+    // its score at the root; Move() if the position is not covered
+    Move bestMove(const Game& game, int& score) const;
+};
+
+// Header written before a table's entries: magic, then the entry count
+void writeBitbaseHeader(unsigned char* out, uint64_t entries);
+
+// The men after a legal move
+EndgameMen menAfter(const EndgameMen& men, Move move);
+
+// Whether a legal move is a double pawn push the opponent can answer with
+// an en passant capture; the game is left as it was
+bool allowsEnPassant(Game& game, Move move);
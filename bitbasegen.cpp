@@ -0,0 +1,574 @@
+// Bitbase generator: builds the win/draw/loss tables of bitbase.h by
+// retrograde analysis, without SFML.
+//
+//   bitbasegen [all3 | all4 | KQvK KRvKN ...] [--dir d] [--threads n] [--verify]
+//
+// Tables are written to --dir (default "bitbases") as <name>.bb. Tables a
+// requested one converts into by a capture or promotion are generated first
+// unless already present. Every pass over a table is split across --threads
+// (default all cores) in blocks of positions. --verify instead re-reads the
+// tables and checks every position against its moves.
+//
+// Each table starts from the mates and stalemates and from the positions
+// decided by converting into a smaller table. Pass L then takes the
+// positions decided at distance L-1 and walks their moves backwards: if
+// they were lost, each predecessor wins in L plies; if they were won, each
+// predecessor is looked at again and is lost once every move from it loses.
+// What is left when no pass decides anything more is a draw.
+//
+// A double pawn push that allows an en passant capture is not walked
+// backwards: the position after it is worth the better of its entry and
+// the capture for the opponent. The positions with such a push are looked
+// at again after every pass instead.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitbase.h"
+
+namespace {
+
+// Working values besides the entries themselves
+const uint8_t UNKNOWN = 254;
+const uint8_t ILLEGAL = 255;
+
+const char PIECE_LETTERS[] = "QRBNP";
+const PieceType PIECE_ORDER[] = { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT, PieceType::PAWN };
+
+// Run fn(game, begin, end) over [0, count) in blocks on all threads, each
+// with its own Game for move generation
+template <typename Fn>
+void parallelFor(size_t count, int threads, Fn fn) {
+    const size_t BLOCK = 1 << 14;
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            Game game;
+            for (size_t begin; (begin = next.fetch_add(BLOCK)) < count;) {
+                fn(game, begin, std::min(count, begin + BLOCK));
+            }
+        });
+    }
+    for (std::thread& thread : pool) thread.join();
+}
+
+Bitboard attacksFrom(PieceType type, int sq, Bitboard occupied) {
+    switch (type) {
+        case PieceType::KNIGHT: return Attacks::knight(sq);
+        case PieceType::BISHOP: return Attacks::bishop(sq, occupied);
+        case PieceType::ROOK:   return Attacks::rook(sq, occupied);
+        case PieceType::QUEEN:  return Attacks::queen(sq, occupied);
+        case PieceType::KING:   return Attacks::king(sq);
+        default:                return 0;
+    }
+}
+
+Board boardOf(const BitbaseLayout& layout, const int* squares) {
+    Board board;
+    for (int i = 0; i < layout.count; i++) board.putPiece(squares[i], layout.pieces[i]);
+    return board;
+}
+
+EndgameMen menOf(const BitbaseLayout& layout, const int* squares, Color sideToMove) {
+    EndgameMen men;
+    men.count = layout.count;
+    for (int i = 0; i < layout.count; i++) {
+        men.pieces[i] = layout.pieces[i];
+        men.squares[i] = squares[i];
+    }
+    men.sideToMove = sideToMove;
+    return men;
+}
+
+// Distinct squares, no pawn on the first or last rank, and the side not
+// to move not in check
+bool isLegalPosition(const BitbaseLayout& layout, const int* squares, Color sideToMove) {
+    Bitboard occupied = 0;
+    for (int i = 0; i < layout.count; i++) {
+        Bitboard b = squareBB(squares[i]);
+        if (occupied & b) return false;
+        if (typeOf(layout.pieces[i]) == PieceType::PAWN && (b & (RANK_1 | RANK_8))) return false;
+        occupied |= b;
+    }
+    Board board = boardOf(layout, squares);
+    int king = board.kingSquare(~sideToMove);
+    return !(board.attackersTo(king, occupied) & board.pieces(sideToMove));
+}
+
+// Name of a material with the stronger side as White; empty for two kings
+std::string nameOf(const PieceCode* pieces, int count) {
+    std::string sides[2];
+    for (int l = 0; l < 5; l++) {
+        for (int i = 0; i < count; i++) {
+            if (typeOf(pieces[i]) == PIECE_ORDER[l]) sides[toIndex(colorOf(pieces[i]))] += PIECE_LETTERS[l];
+        }
+    }
+    if (sides[0].empty() && sides[1].empty()) return "";
+
+    // More men is stronger, then the stronger first man that differs
+    auto strength = [](const std::string& side) {
+        std::string ranks;
+        for (char c : side) ranks += static_cast<char>('9' - (std::string(PIECE_LETTERS).find(c)));
+        return ranks;
+    };
+    if (sides[1].size() > sides[0].size() || (sides[1].size() == sides[0].size() && strength(sides[1]) > strength(sides[0]))) {
+        std::swap(sides[0], sides[1]);
+    }
+    return "K" + sides[0] + "vK" + sides[1];
+}
+
+// Tables reached from a material by one capture or promotion
+std::vector<std::string> conversionsOf(const BitbaseLayout& layout) {
+    std::vector<std::string> names;
+    for (int i = 2; i < layout.count; i++) {
+        PieceCode pieces[Bitbase::MAX_MEN];
+        std::copy(layout.pieces, layout.pieces + layout.count, pieces);
+        std::swap(pieces[i], pieces[layout.count - 1]);
+        names.push_back(nameOf(pieces, layout.count - 1));
+
+        if (typeOf(layout.pieces[i]) != PieceType::PAWN) continue;
+        for (PieceType promoted : { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT }) {
+            std::copy(layout.pieces, layout.pieces + layout.count, pieces);
+            pieces[i] = makePiece(colorOf(layout.pieces[i]), promoted);
+            names.push_back(nameOf(pieces, layout.count));
+        }
+    }
+    names.erase(std::remove(names.begin(), names.end(), std::string()), names.end());
+    return names;
+}
+
+bool tableExists(const std::string& directory, const std::string& name) {
+    return std::ifstream(directory + "/" + name + ".bb").good();
+}
+
+// One table under construction
+class Generator {
+private:
+    const BitbaseLayout& layout;
+    const Bitbases& smaller;   // tables this one converts into
+    int threads;
+    std::unique_ptr<std::atomic<uint8_t>[]> table;
+    std::atomic<int> longest;  // largest distance decided or awaited so far
+    std::vector<size_t> enPassantParents;   // positions with a push allowing en passant
+    std::mutex parentsLock;
+
+    uint8_t at(size_t index) const { return table[index].load(std::memory_order_relaxed); }
+
+    void decided(int plies) {
+        int seen = longest.load();
+        while (plies > seen && !longest.compare_exchange_weak(seen, plies)) {}
+    }
+
+    // Lower an entry to a win in the given plies unless it is already
+    // decided otherwise or won faster
+    void offerWin(size_t index, int plies) {
+        uint8_t entry = Bitbase::entryFor(plies);
+        uint8_t current = at(index);
+        while (current == UNKNOWN || (current != ILLEGAL && Bitbase::isWin(current) && current > entry)) {
+            if (table[index].compare_exchange_weak(current, entry)) {
+                decided(plies);
+                return;
+            }
+        }
+    }
+
+    size_t indexAfter(const int* squares, Color toMove, Move move) const;
+
+    void classify(Game& game, size_t index);
+    void checkLoss(Game& game, size_t index, int maxPlies);
+    void checkEnPassant(Game& game, size_t index, int maxPlies);
+    void retreat(Game& game, size_t index, bool frontierLost);
+
+public:
+    Generator(const BitbaseLayout& tableLayout, const Bitbases& tables, int threadCount)
+        : layout(tableLayout), smaller(tables), threads(threadCount),
+          table(new std::atomic<uint8_t>[tableLayout.size]), longest(0) {}
+
+    // Fill the table; false if a table it converts into is missing
+    bool generate();
+
+    bool write(const std::string& path) const;
+    void report(std::ostream& out) const;
+};
+
+// Index of the position after a move that neither captures nor promotes
+size_t Generator::indexAfter(const int* squares, Color toMove, Move move) const {
+    int child[Bitbase::MAX_MEN];
+    std::copy(squares, squares + layout.count, child);
+    for (int i = 0; i < layout.count; i++) {
+        if (child[i] == move.from()) child[i] = move.to();
+    }
+    return layout.index(child, ~toMove);
+}
+
+// Starting value of a position: mates, stalemates and positions whose
+// moves all leave the table
+void Generator::classify(Game& game, size_t index) {
+    int squares[Bitbase::MAX_MEN];
+    Color toMove;
+    if (!layout.decode(index, squares, toMove) || !isLegalPosition(layout, squares, toMove)) {
+        table[index] = ILLEGAL;
+        return;
+    }
+
+    game.setup(boardOf(layout, squares), toMove);
+    MoveList moves;
+    generateMoves(game, moves);
+    if (moves.size() == 0) {
+        table[index] = game.isInCheck(toMove) ? Bitbase::entryFor(0) : 0;
+        return;
+    }
+
+    EndgameMen men = menOf(layout, squares, toMove);
+    int inTable = 0, fastestWin = -1, slowestLoss = -1;
+    bool draws = false;
+    bool enPassant = false;
+    for (const Move& move : moves) {
+        uint8_t entry;
+        if (game.getBoard().pieceOn(move.to()) == NO_PIECE && move.type() != MoveType::PROMOTION) {
+            inTable++;
+            if (!allowsEnPassant(game, move)) continue;
+            if (!smaller.probeEnPassant(game, move, entry)) {
+                table[index] = ILLEGAL;
+                return;
+            }
+            // The passes have to reach the capture's distance
+            enPassant = true;
+            if (entry != 0) decided(Bitbase::pliesOf(entry));
+            continue;
+        }
+        if (!smaller.probe(menAfter(men, move), entry)) {
+            table[index] = ILLEGAL;
+            return;
+        }
+        int plies = Bitbase::pliesOf(entry) + 1;
+        if (Bitbase::isLoss(entry) && (fastestWin < 0 || plies < fastestWin)) fastestWin = plies;
+        else if (Bitbase::isWin(entry)) slowestLoss = std::max(slowestLoss, plies);
+        else if (entry == 0) draws = true;
+    }
+
+    uint8_t entry = UNKNOWN;
+    if (fastestWin >= 0) entry = Bitbase::entryFor(fastestWin);
+    else if (inTable == 0) entry = draws ? 0 : Bitbase::entryFor(slowestLoss);
+    if (entry != UNKNOWN && entry != 0) decided(Bitbase::pliesOf(entry));
+    table[index] = entry;
+
+    if (enPassant) {
+        std::lock_guard<std::mutex> lock(parentsLock);
+        enPassantParents.push_back(index);
+    }
+}
+
+// An undecided position is lost once every move from it reaches a win for
+// the opponent in at most maxPlies (captures and promotions in any number;
+// after a push allowing en passant, the better of the entry and the capture)
+void Generator::checkLoss(Game& game, size_t index, int maxPlies) {
+    if (at(index) != UNKNOWN) return;
+
+    int squares[Bitbase::MAX_MEN];
+    Color toMove;
+    layout.decode(index, squares, toMove);
+    game.setup(boardOf(layout, squares), toMove);
+    MoveList moves;
+    generateMoves(game, moves);
+
+    EndgameMen men = menOf(layout, squares, toMove);
+    int slowest = 0;
+    for (const Move& move : moves) {
+        uint8_t entry;
+        if (game.getBoard().pieceOn(move.to()) == NO_PIECE && move.type() != MoveType::PROMOTION) {
+            entry = at(indexAfter(squares, toMove, move));
+            uint8_t capture;
+            if (allowsEnPassant(game, move) && smaller.probeEnPassant(game, move, capture)) {
+                // Undecided is no win within maxPlies, so the capture decides
+                entry = (entry == UNKNOWN) ? capture : Bitbase::preferred(entry, capture);
+            }
+            if (entry == UNKNOWN || !Bitbase::isWin(entry) || Bitbase::pliesOf(entry) > maxPlies) return;
+        } else if (!smaller.probe(menAfter(men, move), entry) || !Bitbase::isWin(entry)) {
+            return;
+        }
+        slowest = std::max(slowest, Bitbase::pliesOf(entry) + 1);
+    }
+
+    uint8_t expected = UNKNOWN;
+    if (table[index].compare_exchange_strong(expected, Bitbase::entryFor(slowest))) decided(slowest);
+}
+
+// A position with a push allowing en passant wins through it once the
+// entry after the push and every capture are lost for the opponent, and
+// may be lost like any other
+void Generator::checkEnPassant(Game& game, size_t index, int maxPlies) {
+    uint8_t current = at(index);
+    if (current != UNKNOWN && !Bitbase::isWin(current)) return;
+
+    int squares[Bitbase::MAX_MEN];
+    Color toMove;
+    layout.decode(index, squares, toMove);
+    game.setup(boardOf(layout, squares), toMove);
+    MoveList moves;
+    generateMoves(game, moves);
+
+    for (const Move& move : moves) {
+        if (game.getBoard().pieceOn(move.to()) != NO_PIECE || move.type() == MoveType::PROMOTION) continue;
+        uint8_t after = at(indexAfter(squares, toMove, move)), capture;
+        if (after == UNKNOWN || !Bitbase::isLoss(after) || !allowsEnPassant(game, move)) continue;
+        if (!smaller.probeEnPassant(game, move, capture)) continue;
+        uint8_t entry = Bitbase::preferred(after, capture);
+        if (Bitbase::isLoss(entry)) offerWin(index, Bitbase::pliesOf(entry) + 1);
+    }
+    checkLoss(game, index, maxPlies);
+}
+
+// Walk the quiet moves into a decided position backwards
+void Generator::retreat(Game& game, size_t index, bool frontierLost) {
+    int squares[Bitbase::MAX_MEN];
+    Color toMove;
+    layout.decode(index, squares, toMove);
+    int plies = Bitbase::pliesOf(at(index)) + 1;
+
+    Color mover = ~toMove;
+    Bitboard occupied = 0;
+    for (int i = 0; i < layout.count; i++) occupied |= squareBB(squares[i]);
+
+    for (int i = 0; i < layout.count; i++) {
+        PieceCode piece = layout.pieces[i];
+        if (colorOf(piece) != mover) continue;
+
+        int to = squares[i];
+        Bitboard froms;
+        if (typeOf(piece) == PieceType::PAWN) {
+            int back = (mover == Color::WHITE) ? -8 : 8;
+            int relativeRank = (mover == Color::WHITE) ? rankOf(to) : 7 - rankOf(to);
+            froms = 0;
+            if (relativeRank >= 2 && !(occupied & squareBB(to + back))) {
+                froms |= squareBB(to + back);
+                if (relativeRank == 3 && !(occupied & squareBB(to + 2 * back))) froms |= squareBB(to + 2 * back);
+            }
+        } else {
+            froms = attacksFrom(typeOf(piece), to, occupied) & ~occupied;
+        }
+
+        while (froms) {
+            int before[Bitbase::MAX_MEN];
+            std::copy(squares, squares + layout.count, before);
+            before[i] = popLsb(froms);
+            if (!isLegalPosition(layout, before, mover)) continue;
+            if ((before[i] ^ to) == 16) {
+                game.setup(boardOf(layout, before), mover);
+                if (allowsEnPassant(game, Move(before[i], to))) continue;
+            }
+
+            size_t previous = layout.index(before, mover);
+            if (frontierLost) offerWin(previous, plies);
+            else checkLoss(game, previous, plies - 1);
+        }
+    }
+}
+
+bool Generator::generate() {
+    std::atomic<bool> missing(false);
+    parallelFor(layout.size, threads, [&](Game& game, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            classify(game, i);
+            // A legal position is only illegal here when a table is missing
+            int squares[Bitbase::MAX_MEN];
+            Color toMove;
+            if (at(i) == ILLEGAL && layout.decode(i, squares, toMove) && isLegalPosition(layout, squares, toMove)) {
+                missing = true;
+            }
+        }
+    });
+    if (missing) return false;
+
+    // Decided distances only grow pass by pass, and a loss may be decided
+    // beyond the current pass, so run until past the longest one
+    for (int level = 1; level <= longest.load() + 1; level++) {
+        uint8_t frontier = Bitbase::entryFor(level - 1);
+        bool frontierLost = Bitbase::isLoss(frontier);
+        parallelFor(layout.size, threads, [&](Game& game, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (at(i) == frontier) retreat(game, i, frontierLost);
+            }
+        });
+        parallelFor(enPassantParents.size(), threads, [&](Game& game, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) checkEnPassant(game, enPassantParents[i], level - 1);
+        });
+        if (longest.load() >= UNKNOWN - 2) {
+            std::cerr << layout.name << ": distances exceed the entry range\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Generator::write(const std::string& path) const {
+    std::vector<unsigned char> bytes(Bitbases::HEADER_SIZE + layout.size);
+    writeBitbaseHeader(bytes.data(), layout.size);
+    for (size_t i = 0; i < layout.size; i++) {
+        uint8_t entry = at(i);
+        bytes[Bitbases::HEADER_SIZE + i] = (entry == UNKNOWN || entry == ILLEGAL) ? 0 : entry;
+    }
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return static_cast<bool>(out);
+}
+
+void Generator::report(std::ostream& out) const {
+    size_t wins = 0, draws = 0, losses = 0;
+    int mate = 0;
+    for (size_t i = 0; i < layout.size; i++) {
+        uint8_t entry = at(i);
+        if (entry == ILLEGAL) continue;
+        if (entry == UNKNOWN || entry == 0) draws++;
+        else if (Bitbase::isWin(entry)) wins++;
+        else losses++;
+        if (entry != UNKNOWN && entry != 0) mate = std::max(mate, Bitbase::pliesOf(entry));
+    }
+    out << layout.name << ": " << wins << " won, " << draws << " drawn, " << losses << " lost"
+        << ", longest mate " << mate << " plies";
+}
+
+// Check every position of a written table against its moves: a win has a
+// move to a loss one ply shorter and none to a shorter one, a loss has
+// only moves to wins, the slowest one ply shorter, and a draw neither
+bool verify(const BitbaseLayout& layout, const Bitbases& tables, int threads) {
+    std::atomic<size_t> errors(0);
+    parallelFor(layout.size, threads, [&](Game& game, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            int squares[Bitbase::MAX_MEN];
+            Color toMove;
+            if (!layout.decode(i, squares, toMove) || !isLegalPosition(layout, squares, toMove)) continue;
+
+            EndgameMen men = menOf(layout, squares, toMove);
+            uint8_t entry = 0;
+            tables.probe(men, entry);
+            game.setup(boardOf(layout, squares), toMove);
+            MoveList moves;
+            generateMoves(game, moves);
+
+            int fastestWin = -1, slowestLoss = -1;
+            bool draws = false, covered = true;
+            for (const Move& move : moves) {
+                uint8_t child, capture;
+                if (!tables.probe(menAfter(men, move), child)) covered = false;
+                if (allowsEnPassant(game, move)) {
+                    if (tables.probeEnPassant(game, move, capture)) child = Bitbase::preferred(child, capture);
+                    else covered = false;
+                }
+                int plies = Bitbase::pliesOf(child) + 1;
+                if (Bitbase::isLoss(child) && (fastestWin < 0 || plies < fastestWin)) fastestWin = plies;
+                else if (Bitbase::isWin(child)) slowestLoss = std::max(slowestLoss, plies);
+                else if (child == 0) draws = true;
+            }
+
+            uint8_t expected = 0;
+            if (moves.size() == 0) expected = game.isInCheck(toMove) ? Bitbase::entryFor(0) : 0;
+            else if (fastestWin >= 0) expected = Bitbase::entryFor(fastestWin);
+            else if (!draws) expected = Bitbase::entryFor(slowestLoss);
+            if (!covered || entry != expected) errors++;
+        }
+    });
+    std::cout << layout.name << ": " << (errors ? std::to_string(errors.load()) + " inconsistent positions" : "ok") << "\n";
+    return errors == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory = "bitbases";
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool verifyOnly = false;
+    std::vector<std::string> requested;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) directory = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--verify") verifyOnly = true;
+        else if (arg == "all3" || arg == "all4") {
+            for (const std::string& name : bitbaseNames()) {
+                if (BitbaseLayout(name).count <= arg[3] - '0') requested.push_back(name);
+            }
+        } else if (BitbaseLayout(arg).count) {
+            requested.push_back(nameOf(BitbaseLayout(arg).pieces, BitbaseLayout(arg).count));
+        } else {
+            std::cerr << "Unknown table or option: " << arg << "\n";
+            requested.clear();
+            break;
+        }
+    }
+    if (requested.empty()) {
+        std::cerr << "Usage: bitbasegen [all3 | all4 | KQvK KRvKN ...] [--dir d] [--threads n] [--verify]\n";
+        return 1;
+    }
+
+    Game game;
+    if (verifyOnly) {
+        Bitbases tables;
+        tables.load(directory);
+        bool ok = true;
+        for (const std::string& name : bitbaseNames()) {
+            if (std::find(requested.begin(), requested.end(), name) == requested.end()) continue;
+            if (!tableExists(directory, name)) {
+                std::cout << name << ": missing\n";
+                ok = false;
+                continue;
+            }
+            ok &= verify(BitbaseLayout(name), tables, threads);
+        }
+        return ok ? 0 : 1;
+    }
+
+    // Add the missing tables the requested ones convert into; the names
+    // come in dependency order, so walking them backwards reaches them all
+    std::vector<std::string> names = bitbaseNames();
+    std::vector<bool> wanted(names.size());
+    for (size_t i = names.size(); i-- > 0;) {
+        bool asked = std::find(requested.begin(), requested.end(), names[i]) != requested.end();
+        if (!asked && !(wanted[i] && !tableExists(directory, names[i]))) {
+            wanted[i] = false;
+            continue;
+        }
+        wanted[i] = true;
+        for (const std::string& conversion : conversionsOf(BitbaseLayout(names[i]))) {
+            wanted[std::find(names.begin(), names.end(), conversion) - names.begin()] = true;
+        }
+    }
+
+    // Tables being rebuilt are not mapped while their files are rewritten
+    Bitbases tables;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!wanted[i]) tables.add(directory, names[i]);
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!wanted[i]) continue;
+        BitbaseLayout layout(names[i]);
+        auto start = std::chrono::steady_clock::now();
+
+        Generator generator(layout, tables, threads);
+        std::string path = directory + "/" + layout.name + ".bb";
+        if (!generator.generate()) {
+            std::cerr << layout.name << ": generation failed\n";
+            return 1;
+        }
+        if (!generator.write(path)) {
+            std::cerr << "Cannot write " << path << " (does " << directory << " exist?)\n";
+            return 1;
+        }
+        tables.add(directory, layout.name);
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        generator.report(std::cout);
+        std::cout << " (" << seconds << " s on " << threads << " threads)\n";
+    }
+    return 0;
+}
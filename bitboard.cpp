@@ -0,0 +1,104 @@
+#include "bitboard.h"
+#include "prng.h"
+
+#include <mutex>
+
+namespace Attacks {
+
+Magic rookMagics[64];
+Magic bishopMagics[64];
+bool usePext = false;
+
+namespace {
+
+Bitboard rookTable[0x19000];   // 102400 entries over all squares
+Bitboard bishopTable[0x1480];  // 5248 entries over all squares
+
+Bitboard rankMask(int sq) { return RANK_1 << (8 * rankOf(sq)); }
+Bitboard fileMask(int sq) { return FILE_A << fileOf(sq); }
+
+// Fill one piece type's magic entries for every square
+void initMagics(PieceType type, Bitboard table[], Magic magics[]) {
+    // Seeds per rank that find a working magic quickly
+    const uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+    static Bitboard occupancy[4096];
+    static Bitboard reference[4096];
+    int epoch[4096] = {};
+    int attempt = 0;
+    int size = 0;
+
+    for (int sq = 0; sq < 64; sq++) {
+        Magic& m = magics[sq];
+
+        // Board edges are not blockers unless the piece stands on them
+        Bitboard edges = ((RANK_1 | RANK_8) & ~rankMask(sq)) | ((FILE_A | FILE_H) & ~fileMask(sq));
+        m.mask = slidingAttacks(type, sq, 0) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = (sq == 0) ? table : magics[sq - 1].attacks + size;
+
+        // Enumerate every blocker subset of the mask (carry-rippler)
+        Bitboard b = 0;
+        size = 0;
+        do {
+            occupancy[size] = b;
+            reference[size] = slidingAttacks(type, sq, b);
+#ifdef HAS_PEXT_INSTRUCTION
+            if (usePext) m.attacks[pext(b, m.mask)] = reference[size];
+#endif
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+        if (usePext) continue;
+
+        // Try sparse random candidates until one maps every subset without
+        // a destructive collision
+        PRNG rng(seeds[rankOf(sq)]);
+        for (int i = 0; i < size;) {
+            for (m.magic = 0; popCount((m.magic * m.mask) >> 56) < 6;) {
+                m.magic = rng.sparse();
+            }
+
+            for (++attempt, i = 0; i < size; i++) {
+                unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+// Ray-walk reference used to fill the tables
+Bitboard slidingAttacks(PieceType type, int sq, Bitboard occupied) {
+    return rayAttacks(type == PieceType::BISHOP, sq, occupied);
+}
+
+bool cpuHasPext() {
+#ifdef HAS_PEXT_INSTRUCTION
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+// Rebuild the tables with the chosen indexing scheme
+void build(bool allowPext) {
+    usePext = allowPext && cpuHasPext();
+    initMagics(PieceType::ROOK, rookTable, rookMagics);
+    initMagics(PieceType::BISHOP, bishopTable, bishopMagics);
+}
+
+// Build the tables once
+void init() {
+    static std::once_flag once;
+    std::call_once(once, [] { build(true); });
+}
+
+} // namespace Attacks
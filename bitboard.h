@@ -0,0 +1,209 @@
+#pragma once
+
+#include "types.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAS_PEXT_INSTRUCTION 1
+#endif
+
+constexpr Bitboard RANK_1 = 0xFFULL;
+constexpr Bitboard RANK_2 = RANK_1 << 8;
+constexpr Bitboard RANK_3 = RANK_1 << 16;
+constexpr Bitboard RANK_6 = RANK_1 << 40;
+constexpr Bitboard RANK_7 = RANK_1 << 48;
+constexpr Bitboard RANK_8 = RANK_1 << 56;
+constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H = FILE_A << 7;
+
+// Shift every square one step towards the given side's opponent
+inline Bitboard pawnPush(Color c, Bitboard b) {
+    return c == Color::WHITE ? b << 8 : b >> 8;
+}
+
+// Squares attacked by a set of pawns towards the a-file and the h-file
+inline Bitboard pawnAttacksWest(Color c, Bitboard b) {
+    return c == Color::WHITE ? (b & ~FILE_A) << 7 : (b & ~FILE_A) >> 9;
+}
+
+inline Bitboard pawnAttacksEast(Color c, Bitboard b) {
+    return c == Color::WHITE ? (b & ~FILE_H) << 9 : (b & ~FILE_H) >> 7;
+}
+
+// ============= ATTACK TABLES =============
+
+namespace Attacks {
+
+// The stepping-piece tables and the between/line masks are computed by the
+// compiler and stored in the binary; only the slider tables are built at
+// startup.
+
+// On-board squares reached from sq by each (rank, file) step
+constexpr Bitboard stepAttacks(int sq, const int steps[][2], int count) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; i++) {
+        int rank = rankOf(sq) + steps[i][0];
+        int file = fileOf(sq) + steps[i][1];
+        if (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+            attacks |= squareBB(squareOf(rank, file));
+        }
+    }
+    return attacks;
+}
+
+// Ray walk from sq along rook or bishop lines, stopping at blockers
+constexpr Bitboard rayAttacks(bool diagonal, int sq, Bitboard occupied) {
+    const int rookDirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    const int bishopDirs[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        int dr = diagonal ? bishopDirs[d][0] : rookDirs[d][0];
+        int df = diagonal ? bishopDirs[d][1] : rookDirs[d][1];
+        for (int rank = rankOf(sq) + dr, file = fileOf(sq) + df;
+             rank >= 0 && rank < 8 && file >= 0 && file < 8; rank += dr, file += df) {
+            Bitboard b = squareBB(squareOf(rank, file));
+            attacks |= b;
+            if (occupied & b) break;
+        }
+    }
+    return attacks;
+}
+
+struct StepTables {
+    Bitboard knight[64] = {};
+    Bitboard king[64] = {};
+    Bitboard pawn[2][64] = {};
+};
+
+constexpr StepTables makeStepTables() {
+    const int knightSteps[8][2] = { {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+    const int kingSteps[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    const int whitePawnSteps[2][2] = { {1, -1}, {1, 1} };
+    const int blackPawnSteps[2][2] = { {-1, -1}, {-1, 1} };
+
+    StepTables t;
+    for (int sq = 0; sq < 64; sq++) {
+        t.knight[sq] = stepAttacks(sq, knightSteps, 8);
+        t.king[sq] = stepAttacks(sq, kingSteps, 8);
+        t.pawn[toIndex(Color::WHITE)][sq] = stepAttacks(sq, whitePawnSteps, 2);
+        t.pawn[toIndex(Color::BLACK)][sq] = stepAttacks(sq, blackPawnSteps, 2);
+    }
+    return t;
+}
+
+struct LineTables {
+    Bitboard between[64][64] = {};
+    Bitboard line[64][64] = {};
+};
+
+constexpr LineTables makeLineTables() {
+    LineTables t;
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            for (int d = 0; d < 2; d++) {
+                bool diagonal = (d == 1);
+                if (a != b && (rayAttacks(diagonal, a, 0) & squareBB(b))) {
+                    t.line[a][b] = (rayAttacks(diagonal, a, 0) & rayAttacks(diagonal, b, 0)) | squareBB(a) | squareBB(b);
+                    t.between[a][b] = rayAttacks(diagonal, a, squareBB(b)) & rayAttacks(diagonal, b, squareBB(a));
+                }
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr StepTables STEPS = makeStepTables();
+inline constexpr LineTables LINES = makeLineTables();
+
+constexpr Bitboard knight(int sq) { return STEPS.knight[sq]; }
+constexpr Bitboard king(int sq) { return STEPS.king[sq]; }
+constexpr Bitboard pawn(Color c, int sq) { return STEPS.pawn[toIndex(c)][sq]; }
+
+// Squares strictly between two aligned squares (empty if not aligned)
+constexpr Bitboard between(int a, int b) { return LINES.between[a][b]; }
+
+// Whole rank, file or diagonal through two squares (empty if not aligned)
+constexpr Bitboard line(int a, int b) { return LINES.line[a][b]; }
+
+// Spot checks: b1 knight, a1 and e4 kings, e2/a7 pawns, a1-h8 and e1-e8
+static_assert(knight(1) == (squareBB(11) | squareBB(16) | squareBB(18)), "knight on b1");
+static_assert(king(0) == (squareBB(1) | squareBB(8) | squareBB(9)), "king on a1");
+static_assert(king(28) == 0x0000003828380000ULL, "king on e4");
+static_assert(pawn(Color::WHITE, 12) == (squareBB(19) | squareBB(21)), "white pawn on e2");
+static_assert(pawn(Color::BLACK, 48) == squareBB(41), "black pawn on a7");
+static_assert(between(0, 63) == 0x0040201008040200ULL, "a1-h8 diagonal");
+static_assert(between(4, 60) == 0x0010101010101000ULL, "e-file");
+static_assert(between(0, 17) == 0 && line(0, 17) == 0, "a1 and b3 are not aligned");
+static_assert(line(9, 18) == 0x8040201008040201ULL, "long diagonal through b2 and c3");
+
+// Per-square lookup entry. Tables are indexed either by a magic
+// multiply-shift or, on CPUs with BMI2, by PEXT of the blocker mask.
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const;
+};
+
+extern Magic rookMagics[64];
+extern Magic bishopMagics[64];
+extern bool usePext;
+
+// Build the tables once (safe to call repeatedly and from any thread)
+void init();
+
+// Rebuild the tables with the chosen indexing scheme; used by the self-check
+void build(bool allowPext);
+
+// True when the running CPU supports the PEXT instruction
+bool cpuHasPext();
+
+// Ray-walk reference used to fill the tables
+Bitboard slidingAttacks(PieceType type, int sq, Bitboard occupied);
+
+#ifdef HAS_PEXT_INSTRUCTION
+// Parallel bit extract; emitted as inline asm so generic builds can still
+// use it once the CPU has been checked at runtime
+inline Bitboard pext(Bitboard src, Bitboard mask) {
+    Bitboard result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(src), "rm"(mask));
+    return result;
+}
+#endif
+
+inline unsigned Magic::index(Bitboard occupied) const {
+#ifdef HAS_PEXT_INSTRUCTION
+    if (usePext) return unsigned(pext(occupied, mask));
+#endif
+    return unsigned(((occupied & mask) * magic) >> shift);
+}
+
+inline Bitboard rook(int sq, Bitboard occupied) {
+    const Magic& m = rookMagics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishop(int sq, Bitboard occupied) {
+    const Magic& m = bishopMagics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queen(int sq, Bitboard occupied) {
+    return rook(sq, occupied) | bishop(sq, occupied);
+}
+
+// Attacks of a piece type fixed at compile time, so callers templated on
+// the piece need no run-time dispatch (pawns are told apart by color)
+template <PieceType Pt>
+inline Bitboard of(int sq, Bitboard occupied) {
+    static_assert(Pt != PieceType::PAWN && Pt != PieceType::NONE, "no color-independent attacks");
+    if constexpr (Pt == PieceType::KNIGHT) return knight(sq);
+    else if constexpr (Pt == PieceType::BISHOP) return bishop(sq, occupied);
+    else if constexpr (Pt == PieceType::ROOK) return rook(sq, occupied);
+    else if constexpr (Pt == PieceType::QUEEN) return queen(sq, occupied);
+    else return king(sq);
+}
+
+} // namespace Attacks
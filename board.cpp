@@ -0,0 +1,57 @@
+#include "board.h"
+
+#include <iostream>
+
+// ============= BOARD CLASS IMPLEMENTATIONS =============
+
+// Board constructor
+Board::Board() {
+    clear();
+}
+
+// Remove every piece
+void Board::clear() {
+    for (Bitboard& b : byType) b = 0;
+    for (Bitboard& b : byColor) b = 0;
+    for (PieceCode& p : mailbox) p = NO_PIECE;
+}
+
+// Initialize the board with pieces in starting positions
+void Board::initialize() {
+    clear();
+
+    const PieceType backRank[8] = {
+        PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+        PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
+    };
+
+    for (int file = 0; file < 8; file++) {
+        putPiece(squareOf(0, file), makePiece(Color::WHITE, backRank[file]));
+        putPiece(squareOf(1, file), makePiece(Color::WHITE, PieceType::PAWN));
+        putPiece(squareOf(6, file), makePiece(Color::BLACK, PieceType::PAWN));
+        putPiece(squareOf(7, file), makePiece(Color::BLACK, backRank[file]));
+    }
+}
+
+// Set piece at position
+void Board::setPiece(Position pos, PieceCode piece) {
+    if (!pos.isValid()) return;
+    int sq = toSquare(pos);
+    if (mailbox[sq] != NO_PIECE) removePiece(sq);
+    if (piece != NO_PIECE) putPiece(sq, piece);
+}
+
+// Display the board (text-based)
+void Board::display() const {
+    const char symbols[] = "PRNBQKprnbqk.";
+
+    std::cout << "\n  a b c d e f g h\n";
+    for (int row = 0; row < 8; row++) {
+        std::cout << (8 - row) << " ";
+        for (int col = 0; col < 8; col++) {
+            std::cout << symbols[getPiece(Position(row, col))] << " ";
+        }
+        std::cout << (8 - row) << "\n";
+    }
+    std::cout << "  a b c d e f g h\n\n";
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "types.h"
+#include "bitboard.h"
+
+// Board class - bitboard piece placement with a byte-per-square mailbox
+class Board {
+private:
+    Bitboard byType[6];
+    Bitboard byColor[2];
+    PieceCode mailbox[64];
+
+public:
+    Board();
+
+    // Initialize the board with pieces in starting positions
+    void initialize();
+
+    // Remove every piece
+    void clear();
+
+    // Get piece at position (NO_PIECE if empty or off the board)
+    PieceCode getPiece(Position pos) const;
+
+    // Set piece at position
+    void setPiece(Position pos, PieceCode piece);
+
+    // Check if position is empty
+    bool isEmpty(Position pos) const;
+
+    // Square-indexed primitives used by the game and move generation
+    PieceCode pieceOn(int sq) const { return mailbox[sq]; }
+    void putPiece(int sq, PieceCode piece);
+    void removePiece(int sq);
+    void movePiece(int from, int to);
+
+    // Occupancy masks
+    Bitboard pieces() const { return byColor[0] | byColor[1]; }
+    Bitboard pieces(Color c) const { return byColor[toIndex(c)]; }
+    Bitboard pieces(PieceType t) const { return byType[toIndex(t)]; }
+    Bitboard pieces(Color c, PieceType t) const { return byColor[toIndex(c)] & byType[toIndex(t)]; }
+
+    // Square of the given side's king (NO_SQUARE if it has none)
+    int kingSquare(Color c) const;
+
+    // Pieces of either color attacking a square, given an occupancy
+    Bitboard attackersTo(int sq, Bitboard occupied) const;
+
+    // Display the board
+    void display() const;
+};
+
+inline void Board::putPiece(int sq, PieceCode piece) {
+    Bitboard b = squareBB(sq);
+    byType[piece % 6] |= b;
+    byColor[piece / 6] |= b;
+    mailbox[sq] = piece;
+}
+
+inline void Board::removePiece(int sq) {
+    PieceCode piece = mailbox[sq];
+    Bitboard b = squareBB(sq);
+    byType[piece % 6] ^= b;
+    byColor[piece / 6] ^= b;
+    mailbox[sq] = NO_PIECE;
+}
+
+inline void Board::movePiece(int from, int to) {
+    PieceCode piece = mailbox[from];
+    Bitboard b = squareBB(from) | squareBB(to);
+    byType[piece % 6] ^= b;
+    byColor[piece / 6] ^= b;
+    mailbox[from] = NO_PIECE;
+    mailbox[to] = piece;
+}
+
+inline PieceCode Board::getPiece(Position pos) const {
+    return pos.isValid() ? mailbox[toSquare(pos)] : NO_PIECE;
+}
+
+inline bool Board::isEmpty(Position pos) const {
+    return getPiece(pos) == NO_PIECE;
+}
+
+inline int Board::kingSquare(Color c) const {
+    Bitboard king = pieces(c, PieceType::KING);
+    return king ? lsb(king) : NO_SQUARE;
+}
+
+inline Bitboard Board::attackersTo(int sq, Bitboard occupied) const {
+    return (Attacks::pawn(Color::BLACK, sq) & pieces(Color::WHITE, PieceType::PAWN))
+         | (Attacks::pawn(Color::WHITE, sq) & pieces(Color::BLACK, PieceType::PAWN))
+         | (Attacks::knight(sq) & pieces(PieceType::KNIGHT))
+         | (Attacks::bishop(sq, occupied) & (pieces(PieceType::BISHOP) | pieces(PieceType::QUEEN)))
+         | (Attacks::rook(sq, occupied) & (pieces(PieceType::ROOK) | pieces(PieceType::QUEEN)))
+         | (Attacks::king(sq) & pieces(PieceType::KING));
+}
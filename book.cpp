@@ -0,0 +1,154 @@
+#include "book.h"
+
+#include <array>
+
+#include "prng.h"
+
+namespace {
+
+uint64_t readBigEndian(const unsigned char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value = (value << 8) | p[i];
+    return value;
+}
+
+void writeBigEndian(unsigned char* p, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        p[i] = static_cast<unsigned char>(value);
+        value >>= 8;
+    }
+}
+
+// Polyglot promotion codes: 1 knight, 2 bishop, 3 rook, 4 queen
+int promotionCode(PieceType type) {
+    switch (type) {
+        case PieceType::KNIGHT: return 1;
+        case PieceType::BISHOP: return 2;
+        case PieceType::ROOK:   return 3;
+        case PieceType::QUEEN:  return 4;
+        default:                return 0;
+    }
+}
+
+// Random64 in the Polyglot layout: 768 piece-square values (kind * 64 +
+// square, kinds black pawn, white pawn, black knight, ... white king),
+// then four castling rights, eight en passant files and the side to move.
+// The values are drawn from a fixed seed, never from the engine's Zobrist
+// table, so books survive changes to it; the published Polyglot constants
+// can replace them as they are.
+const int RANDOM_CASTLE = 768;
+const int RANDOM_EN_PASSANT = 772;
+const int RANDOM_TURN = 780;
+
+const std::array<uint64_t, 781>& random64() {
+    static const std::array<uint64_t, 781> table = [] {
+        std::array<uint64_t, 781> t {};
+        PRNG rng(781);
+        for (uint64_t& value : t) value = rng.next();
+        return t;
+    }();
+    return table;
+}
+
+// Polyglot piece kinds order pawn, knight, bishop, rook, queen, king
+int polyglotKind(PieceCode piece) {
+    static const int ORDER[6] = { 0, 3, 1, 2, 4, 5 };   // by PieceType
+    return 2 * ORDER[toIndex(typeOf(piece))] + (colorOf(piece) == Color::WHITE ? 1 : 0);
+}
+
+} // namespace
+
+uint64_t polyglotKey(const Game& game) {
+    const std::array<uint64_t, 781>& random = random64();
+    const Board& board = game.getBoard();
+
+    uint64_t key = 0;
+    for (Bitboard occupied = board.pieces(); occupied;) {
+        int sq = popLsb(occupied);
+        key ^= random[64 * polyglotKind(board.pieceOn(sq)) + sq];
+    }
+
+    const uint8_t rights[4] = { WHITE_OO, WHITE_OOO, BLACK_OO, BLACK_OOO };
+    for (int i = 0; i < 4; i++) {
+        if (game.getCastlingRights() & rights[i]) key ^= random[RANDOM_CASTLE + i];
+    }
+
+    // The en passant file counts only when a pawn can actually capture
+    Color us = game.getCurrentPlayer();
+    int ep = game.getEpSquare();
+    if (ep != NO_SQUARE && (Attacks::pawn(~us, ep) & board.pieces(us, PieceType::PAWN))) {
+        key ^= random[RANDOM_EN_PASSANT + fileOf(ep)];
+    }
+
+    if (us == Color::WHITE) key ^= random[RANDOM_TURN];
+    return key;
+}
+
+uint16_t encodeBookMove(Move move) {
+    int to = move.to();
+    if (move.type() == MoveType::CASTLING) {
+        to = squareOf(rankOf(to), fileOf(to) == 6 ? 7 : 0);
+    }
+    int promotion = (move.type() == MoveType::PROMOTION) ? promotionCode(move.promotion()) : 0;
+    return static_cast<uint16_t>(to | (move.from() << 6) | (promotion << 12));
+}
+
+void writeBookEntry(unsigned char* out, uint64_t key, uint16_t move, uint16_t weight) {
+    writeBigEndian(out, key, 8);
+    writeBigEndian(out + 8, move, 2);
+    writeBigEndian(out + 10, weight, 2);
+    writeBigEndian(out + 12, 0, 4);
+}
+
+OpeningBook::OpeningBook(const std::string& path) : file(path, MappedFile::Access::RANDOM), count(file.size() / ENTRY_SIZE) {}
+
+uint64_t OpeningBook::keyAt(size_t i) const {
+    return readBigEndian(file.data() + i * ENTRY_SIZE, 8);
+}
+
+void OpeningBook::probe(const Game& game, MoveList& moves) const {
+    moves.clear();
+    uint64_t key = polyglotKey(game);
+
+    // First entry with this key
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (keyAt(mid) < key) low = mid + 1;
+        else high = mid;
+    }
+    if (low == count || keyAt(low) != key) return;
+
+    // Entries are checked against the legal moves, so a key collision or a
+    // damaged file can never produce an illegal move
+    MoveList legal;
+    generateMoves(game, legal);
+    for (size_t i = low; i < count && keyAt(i) == key && moves.size() < MoveList::CAPACITY; i++) {
+        const unsigned char* entry = file.data() + i * ENTRY_SIZE;
+        uint16_t code = static_cast<uint16_t>(readBigEndian(entry + 8, 2));
+        int weight = static_cast<int>(readBigEndian(entry + 10, 2));
+        for (const Move& move : legal) {
+            if (encodeBookMove(move) == code) {
+                moves.push_back(move);
+                moves.score(moves.size() - 1) = weight;
+                break;
+            }
+        }
+    }
+}
+
+Move OpeningBook::pick(const Game& game, uint64_t random) const {
+    MoveList moves;
+    probe(game, moves);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < moves.size(); i++) total += moves.score(i);
+    if (total == 0) return Move();
+
+    uint64_t target = random % total;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (target < static_cast<uint64_t>(moves.score(i))) return moves[i];
+        target -= moves.score(i);
+    }
+    return Move();
+}
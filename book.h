@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "game.h"
+#include "mappedfile.h"
+#include "movegen.h"
+
+// Opening book in the Polyglot .bin layout: 16-byte big-endian entries of
+// key, move, weight and learn data, sorted by key. Keys are computed by
+// polyglotKey(), independent of the engine's Zobrist keys.
+class OpeningBook {
+private:
+    MappedFile file;
+    size_t count;
+
+    uint64_t keyAt(size_t i) const;
+
+public:
+    static const size_t ENTRY_SIZE = 16;
+
+    explicit OpeningBook(const std::string& path);
+
+    bool isOpen() const { return file.isOpen(); }
+    size_t size() const { return count; }
+
+    // The legal book moves for the position, each with its weight as score
+    void probe(const Game& game, MoveList& moves) const;
+
+    // A book move picked at random in proportion to the weights, from a
+    // caller-supplied random number; Move() when out of book
+    Move pick(const Game& game, uint64_t random) const;
+};
+
+// Book key of a position, hashed by the Polyglot rules: pieces, castling
+// rights, the en passant file only when a capture is possible, and the
+// side to move. The Random64 values are this engine's own (see book.cpp),
+// so books must come from bookbuild.
+uint64_t polyglotKey(const Game& game);
+
+// Polyglot move encoding (to, from, promotion; castling as king takes rook)
+uint16_t encodeBookMove(Move move);
+
+// Write one entry in the book layout
+void writeBookEntry(unsigned char* out, uint64_t key, uint16_t move, uint16_t weight);
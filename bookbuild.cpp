@@ -0,0 +1,157 @@
+// Book builder: turns a PGN file into an opening book in the Polyglot .bin
+// layout (see book.h for the key used), without SFML.
+//
+//   bookbuild <in.pgn> <out.bin> [--plies n] [--min-games n] [--threads n]
+//
+// Every move in the first --plies plies (default 20) of every game with a
+// result counts for the side that played it: 2 for a win, 1 for a draw and
+// 0 for a loss, as in Polyglot. Moves played in fewer than --min-games
+// games (default 1) and moves that only ever lost are left out. The PGN is
+// read on all cores, one piece of the file per thread.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "book.h"
+#include "pgn.h"
+
+namespace {
+
+// One occurrence, and after merging the total, of a move in a position
+struct BookRecord {
+    uint64_t key;
+    uint16_t move;
+    uint32_t weight;
+    uint32_t games;
+
+    bool operator<(const BookRecord& other) const {
+        return key != other.key ? key < other.key : move < other.move;
+    }
+};
+
+// Collects the opening moves of each game until its result is known
+class BookVisitor : public PgnVisitor {
+private:
+    int maxPlies;
+    std::vector<BookRecord> pending;   // this game's moves so far
+    std::vector<Color> movers;
+
+public:
+    std::vector<BookRecord> records;
+
+    explicit BookVisitor(int plies) : maxPlies(plies) {}
+
+    bool startGame(const Game&) override {
+        pending.clear();
+        movers.clear();
+        return true;
+    }
+
+    void move(const Game& game, Move move) override {
+        if (static_cast<int>(pending.size()) >= maxPlies) return;
+        pending.push_back({ polyglotKey(game), encodeBookMove(move), 0, 1 });
+        movers.push_back(game.getCurrentPlayer());
+    }
+
+    void endGame(const Game&, std::string_view result, bool) override {
+        if (result == "*") return;
+        for (size_t i = 0; i < pending.size(); i++) {
+            bool won = (result == "1-0") == (movers[i] == Color::WHITE);
+            pending[i].weight = (result == "1/2-1/2") ? 1 : won ? 2 : 0;
+            records.push_back(pending[i]);
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int plies = 20;
+    unsigned minGames = 1;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--plies" && i + 1 < argc) plies = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--min-games" && i + 1 < argc) minGames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else paths.push_back(arg);
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: bookbuild <in.pgn> <out.bin> [--plies n] [--min-games n] [--threads n]\n";
+        return 1;
+    }
+
+    MappedFile pgn(paths[0], MappedFile::Access::SEQUENTIAL);
+    if (!pgn.isOpen()) {
+        std::cerr << "Cannot read " << paths[0] << "\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<BookVisitor>> visitors;
+    std::vector<PgnVisitor*> pointers;
+    for (int i = 0; i < threads; i++) {
+        visitors.emplace_back(new BookVisitor(plies));
+        pointers.push_back(visitors.back().get());
+    }
+    PgnStats stats = readPgnParallel(pgn.text(), pointers);
+
+    std::vector<BookRecord> records;
+    for (const auto& v : visitors) {
+        records.insert(records.end(), v->records.begin(), v->records.end());
+        v->records = std::vector<BookRecord>();
+    }
+    std::sort(records.begin(), records.end());
+
+    // Merge repeats of the same move in the same position
+    std::vector<BookRecord> merged;
+    for (const BookRecord& r : records) {
+        if (!merged.empty() && merged.back().key == r.key && merged.back().move == r.move) {
+            merged.back().weight += r.weight;
+            merged.back().games += r.games;
+        } else {
+            merged.push_back(r);
+        }
+    }
+    merged.erase(std::remove_if(merged.begin(), merged.end(), [&](const BookRecord& r) {
+        return r.weight == 0 || r.games < minGames;
+    }), merged.end());
+
+    // Weights are 16 bits; scale a position's moves down together if needed
+    for (size_t first = 0; first < merged.size();) {
+        size_t last = first;
+        uint32_t heaviest = 0;
+        for (; last < merged.size() && merged[last].key == merged[first].key; last++) {
+            heaviest = std::max(heaviest, merged[last].weight);
+        }
+        if (heaviest > 0xFFFF) {
+            for (size_t i = first; i < last; i++) {
+                merged[i].weight = std::max<uint32_t>(1, static_cast<uint32_t>(uint64_t(merged[i].weight) * 0xFFFF / heaviest));
+            }
+        }
+        first = last;
+    }
+
+    std::ofstream out(paths[1], std::ios::binary);
+    unsigned char entry[OpeningBook::ENTRY_SIZE];
+    for (const BookRecord& r : merged) {
+        writeBookEntry(entry, r.key, r.move, static_cast<uint16_t>(r.weight));
+        out.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+    }
+    if (!out) {
+        std::cerr << "Cannot write " << paths[1] << "\n";
+        return 1;
+    }
+
+    size_t positions = 0;
+    for (size_t i = 0; i < merged.size(); i++) positions += (i == 0 || merged[i].key != merged[i - 1].key);
+    std::cout << stats.games << " games (" << stats.errors << " with errors), " << merged.size()
+              << " book moves in " << positions << " positions written to " << paths[1] << "\n";
+    return 0;
+}
@@ -17,13 +17,13 @@ fi
 
 # Compile the chess game
 if [ -n "$SFML_PREFIX" ]; then
-    clang++ -std=c++17 -Wall chess.cpp -o chess \
+    clang++ -std=c++17 -Wall -O2 -pthread chess.cpp bitboard.cpp board.cpp piece.cpp game.cpp movegen.cpp notation.cpp zobrist.cpp tt.cpp evaluate.cpp search.cpp movepick.cpp mappedfile.cpp pgn.cpp book.cpp bitbase.cpp -o chess \
         -I"$SFML_PREFIX/include" \
         -L"$SFML_PREFIX/lib" \
         -lsfml-graphics -lsfml-window -lsfml-system \
         -Wl,-rpath,"$SFML_PREFIX/lib"
 else
-    clang++ -std=c++17 -Wall chess.cpp -o chess -lsfml-graphics -lsfml-window -lsfml-system
+    clang++ -std=c++17 -Wall -O2 -pthread chess.cpp bitboard.cpp board.cpp piece.cpp game.cpp movegen.cpp notation.cpp zobrist.cpp tt.cpp evaluate.cpp search.cpp movepick.cpp mappedfile.cpp pgn.cpp book.cpp bitbase.cpp -o chess -lsfml-graphics -lsfml-window -lsfml-system
 fi
 
 if [ $? -eq 0 ]; then
@@ -1,47 +1,31 @@
 #include <iostream>
 #include <vector>
-#include <memory>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
-#include <ctime>
+#include <memory>
+#include <thread>
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp> 
 
+#include "bitbase.h"
+#include "book.h"
+#include "game.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "prng.h"
+#include "search.h"
+
 const int SQUARE_SIZE = 80; 
 
 const int BOARD_SIZE = 8;
 const int WINDOW_SIZE = SQUARE_SIZE * BOARD_SIZE;
+const int DEFAULT_AI_MOVE_TIME_MS = 1000;
 
 
-// Enums for piece types and colors
-enum class PieceType {
-    PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING, NONE
-};
-
-enum class Color {
-    WHITE, BLACK, NONE
-};
-
-// Position structure to represent board coordinates
-struct Position {
-    int row;
-    int col;
-
-    Position(int r = 0, int c = 0) : row(r), col(c) {}
-    bool isValid() const{
-        return row >= 0 && row < 8 && col >= 0 && col < 8;
-    }
-    bool operator==(const Position& other) const {
-        return row == other.row && col == other.col;
-    }
-};
-
-// Forward declarations
-class Game;
-class Piece;
-class Board;
-
 enum class GameState {
     MENU,
     PLAYING,
@@ -57,6 +41,11 @@ class ChessGUI {
     sf::Color darkSquare;
 
     Game* game;
+    Search* search;
+
+    // Opening book, if any; its moves are played without searching
+    const OpeningBook* book;
+    PRNG bookRandom;
 
     bool pieceSelected;
     Position selectedPos;
@@ -65,34 +54,62 @@ class ChessGUI {
     GameState state;
     Color playerColor;
     Color aiColor;
-    bool isAITurn;
+    std::string resultText;
+
+    // The AI thinks on its own thread; the render loop polls for the result
+    std::thread aiThread;
+    bool aiThinking;
+    std::atomic<bool> aiResultReady;
+    SearchResult aiResult;
+
+    // AI time budget: a fixed time per move, or a clock with increment
+    int aiMoveTimeMs;
+    int aiClockMs;
+    int aiIncrementMs;
 
     public:
         ChessGUI() : window(sf::VideoMode({WINDOW_SIZE, WINDOW_SIZE + 100}), "Chess Game"),
         lightSquare(240, 217, 181),
         darkSquare(181, 136, 99),
         game(nullptr),
+        search(nullptr),
+        book(nullptr),
+        bookRandom(std::chrono::steady_clock::now().time_since_epoch().count() | 1),
         pieceSelected(false),
         selectedPos(-1, -1),
         state(GameState::MENU),
         playerColor(Color::WHITE),
         aiColor(Color::BLACK),
-        isAITurn(false) {
+        aiThinking(false),
+        aiResultReady(false),
+        aiMoveTimeMs(DEFAULT_AI_MOVE_TIME_MS),
+        aiClockMs(0),
+        aiIncrementMs(0) {
             if (!font.openFromFile("/System/Library/Fonts/Supplemental/Arial.ttf")) {
                 std::cerr << "Failed to load font\n";
             }
         }
 
+        ~ChessGUI() { cancelAIMove(); }
+
         void setGame(Game* g);
+        void setSearch(Search* s);
+        void setBook(const OpeningBook* b);
         void run();
         void setPlayerColor(Color color);
+        void setAIMoveTime(int milliseconds);
+        void setAIClock(int milliseconds, int incrementMs);
 
 private:
     void handleEvents();
     void handleMenuClick(int x, int y);
     void handleMouseClick(int x, int y);
     void calculateValidMoves();
-    void makeAIMove();
+    void startAIMove();
+    void pollAIMove();
+    void cancelAIMove();
+    void closeWindow();
+    void checkGameOver();
 
     void render();
     void drawMenu();
@@ -102,537 +119,70 @@ private:
     std::string getPieceUnicode(PieceType type, Color color);
 };
 
-// Base Piece class
-class Piece {
-protected:
-    Color color;
-    PieceType type;
-    Position position;
-    bool hasMoved;
-    
-public:
-    Piece(Color c, PieceType t, Position pos);
-    virtual ~Piece() = default;
-    
-    // Getters
-    Color getColor() const;
-    PieceType getType() const;
-    Position getPosition() const;
-    bool hasMovedBefore() const;
-    
-    // Setters
-    void setPosition(Position pos);
-    void setHasMoved(bool moved);
-    
-    // Pure virtual function - each piece implements its own move logic
-    virtual bool isValidMove(Position from, Position to, class Board& board) const = 0;
-    
-    // Virtual function for getting piece symbol
-    virtual char getSymbol() const = 0;
-};
-
-// Derived piece classes
-class Pawn : public Piece {
-public:
-    Pawn(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-class Rook : public Piece {
-public:
-    Rook(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-class Knight : public Piece {
-public:
-    Knight(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-class Bishop : public Piece {
-public:
-    Bishop(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-class Queen : public Piece {
-public:
-    Queen(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-class King : public Piece {
-public:
-    King(Color c, Position pos);
-    bool isValidMove(Position from, Position to, Board& board) const override;
-    char getSymbol() const override;
-};
-
-// After your class declarations, add these:
-
-// Pawn
-Pawn::Pawn(Color c, Position pos) : Piece(c, PieceType::PAWN, pos) {}
-char Pawn::getSymbol() const { return (color == Color::WHITE) ? 'P' : 'p'; }
-
-// Rook
-Rook::Rook(Color c, Position pos) : Piece(c, PieceType::ROOK, pos) {}
-char Rook::getSymbol() const { return (color == Color::WHITE) ? 'R' : 'r'; }
-
-// Knight
-Knight::Knight(Color c, Position pos) : Piece(c, PieceType::KNIGHT, pos) {}
-char Knight::getSymbol() const { return (color == Color::WHITE) ? 'N' : 'n'; }
-
-// Bishop
-Bishop::Bishop(Color c, Position pos) : Piece(c, PieceType::BISHOP, pos) {}
-char Bishop::getSymbol() const { return (color == Color::WHITE) ? 'B' : 'b'; }
-
-// Queen
-Queen::Queen(Color c, Position pos) : Piece(c, PieceType::QUEEN, pos) {}
-char Queen::getSymbol() const { return (color == Color::WHITE) ? 'Q' : 'q'; }
-
-// King
-King::King(Color c, Position pos) : Piece(c, PieceType::KING, pos) {}
-char King::getSymbol() const { return (color == Color::WHITE) ? 'K' : 'k'; }
-
-// Board class
-class Board {
-private:
-    std::vector<std::vector<std::shared_ptr<Piece>>> board;
-    
-public:
-    Board();
-    
-    // Initialize the board with pieces in starting positions
-    void initialize();
-    
-    // Get piece at position
-    std::shared_ptr<Piece> getPiece(Position pos) const;
-    
-    // Set piece at position
-    void setPiece(Position pos, std::shared_ptr<Piece> piece);
-    
-    // Check if position is empty
-    bool isEmpty(Position pos) const;
-    
-    // Check if path is clear (for rook, bishop, queen moves)
-    bool isPathClear(Position from, Position to) const;
-    
-    // Display the board
-    void display() const;
-};
-
-// Move structure
-struct Move {
-    Position from;
-    Position to;
-    std::shared_ptr<Piece> capturedPiece;
-    
-    Move(Position f, Position t) : from(f), to(t), capturedPiece(nullptr) {}
-};
-
-// Game class - manages the game state
-class Game {
-private:
-    Board board;
-    Color currentPlayer;
-    std::vector<Move> moveHistory;
-    bool gameOver;
-    
-public:
-    Game();
-    
-    // Start the game
-    void start();
-    
-    // Make a move
-    bool makeMove(Position from, Position to);
-    
-    // Validate move
-    bool isValidMove(Position from, Position to) const;
-    
-    // Check if king is in check
-    bool isInCheck(Color color) const;
-    
-    // Check if king is in checkmate
-    bool isCheckmate(Color color) const;
-    
-    // Check if game is stalemate
-    bool isStalemate(Color color) const;
-    
-    // Switch player turn
-    void switchPlayer();
-    
-    // Get current player
-    Color getCurrentPlayer() const;
-
-    // Get piece at position
-    std::shared_ptr<Piece> getPieceAt(Position pos) const;
-
-    // Game loop
-    void play();
-
-    // Undo last move
-    void undoMove();
-};
-
-void Board::initialize() { 
-    for (int i = 0; i < 8; i++) { 
-        for (int j = 0; j < 8; j++){ 
-            board[i][j] = nullptr;
-        }
-    }
-
-    board[0][0] = std::make_shared<Rook>(Color::WHITE, Position(0,0));
-    board[0][1] = std::make_shared<Knight>(Color::WHITE, Position(0,1));
-    board[0][2] = std::make_shared<Bishop>(Color::WHITE, Position(0,2));
-    board[0][3] = std::make_shared<Queen>(Color::WHITE, Position(0,3));
-    board[0][4] = std::make_shared<King>(Color::WHITE, Position(0,4));
-    board[0][5] = std::make_shared<Bishop>(Color::WHITE, Position(0,5));
-    board[0][6] = std::make_shared<Knight>(Color::WHITE, Position(0,6));
-    board[0][7] = std::make_shared<Rook>(Color::WHITE, Position(0,7));
-
-
-
-    for (int col = 0; col < 8; col++) {
-        board[1][col] = std::make_shared<Pawn>(Color::BLACK, Position(1, col));
-    }
-
-    for (int col = 0; col < 8; col++) {
-        board[6][col] = std::make_shared<Pawn>(Color::WHITE, Position(6, col));
-    }
-
-    board[7][0] = std::make_shared<Rook>(Color::BLACK, Position(7,0));
-    board[7][1] = std::make_shared<Knight>(Color::BLACK, Position(7,1));
-    board[7][2] = std::make_shared<Bishop>(Color::BLACK, Position(7,2));
-    board[7][3] = std::make_shared<Queen>(Color::BLACK, Position(7,3));
-    board[7][4] = std::make_shared<King>(Color::BLACK, Position(7,4));
-    board[7][5] = std::make_shared<Bishop>(Color::BLACK, Position(7,5));
-    board[7][6] = std::make_shared<Knight>(Color::BLACK, Position(7,6));
-    board[7][7] = std::make_shared<Rook>(Color::BLACK, Position(7,7));
-
-}
-
-Game::Game() : currentPlayer(Color::WHITE), gameOver(false) { 
-    board.initialize();
-}
-
-void Game::start() { 
-    board.initialize(); 
-    currentPlayer = Color::WHITE; 
-    gameOver = false; 
-    std::cout << "Chess game started!\n";
-}
-
-void Game::play() { 
-    board.display();
-    std::cout << "Game loop - implement GUI here\n";
-}
-
-Color Game::getCurrentPlayer() const { 
-    return currentPlayer;
-}
-
-void Game::switchPlayer() {
-    currentPlayer = (currentPlayer == Color::WHITE) ? Color::BLACK : Color::WHITE;
-}
-
-std::shared_ptr<Piece> Game::getPieceAt(Position pos) const {
-    return board.getPiece(pos);
-}
-
-// ============= PIECE CLASS IMPLEMENTATIONS =============
-
-// Piece constructor
-Piece::Piece(Color c, PieceType t, Position pos) 
-    : color(c), type(t), position(pos), hasMoved(false) {}
-
-// Piece getters
-Color Piece::getColor() const { return color; }
-PieceType Piece::getType() const { return type; }
-Position Piece::getPosition() const { return position; }
-bool Piece::hasMovedBefore() const { return hasMoved; }
-
-// Piece setters
-void Piece::setPosition(Position pos) { position = pos; }
-void Piece::setHasMoved(bool moved) { hasMoved = moved; }
-
-// ============= BOARD CLASS IMPLEMENTATIONS =============
-
-// Board constructor
-Board::Board() {
-    board.resize(8, std::vector<std::shared_ptr<Piece>>(8, nullptr));
-}
-
-// Get piece at position
-std::shared_ptr<Piece> Board::getPiece(Position pos) const {
-    if (!pos.isValid()) return nullptr;
-    return board[pos.row][pos.col];
-}
-
-// Set piece at position
-void Board::setPiece(Position pos, std::shared_ptr<Piece> piece) {
-    if (!pos.isValid()) return;
-    board[pos.row][pos.col] = piece;
-    if (piece) {
-        piece->setPosition(pos);
-    }
-}
-
-// Check if position is empty
-bool Board::isEmpty(Position pos) const {
-    return getPiece(pos) == nullptr;
-}
-
-// Check if path is clear (for sliding pieces)
-bool Board::isPathClear(Position from, Position to) const {
-    int rowDir = (to.row > from.row) ? 1 : (to.row < from.row) ? -1 : 0;
-    int colDir = (to.col > from.col) ? 1 : (to.col < from.col) ? -1 : 0;
-    
-    int currentRow = from.row + rowDir;
-    int currentCol = from.col + colDir;
-    
-    while (currentRow != to.row || currentCol != to.col) {
-        if (!isEmpty(Position(currentRow, currentCol))) {
-            return false;
-        }
-        currentRow += rowDir;
-        currentCol += colDir;
-    }
-    
-    return true;
-}
-
-// Display the board (text-based)
-void Board::display() const {
-    std::cout << "\n  a b c d e f g h\n";
-    for (int row = 0; row < 8; row++) {
-        std::cout << (8 - row) << " ";
-        for (int col = 0; col < 8; col++) {
-            auto piece = getPiece(Position(row, col));
-            if (piece) {
-                std::cout << piece->getSymbol() << " ";
-            } else {
-                std::cout << ". ";
-            }
-        }
-        std::cout << (8 - row) << "\n";
-    }
-    std::cout << "  a b c d e f g h\n\n";
-}
-
-// ============= PIECE MOVE VALIDATION =============
-
-// Pawn move validation
-bool Pawn::isValidMove(Position from, Position to, Board& board) const {
-    int direction = (color == Color::WHITE) ? -1 : 1;
-    int startRow = (color == Color::WHITE) ? 6 : 1;
-    
-    // Move forward one square
-    if (to.col == from.col && to.row == from.row + direction) {
-        return board.isEmpty(to);
-    }
-    
-    // Move forward two squares from starting position
-    if (to.col == from.col && from.row == startRow && to.row == from.row + 2 * direction) {
-        return board.isEmpty(to) && board.isEmpty(Position(from.row + direction, from.col));
-    }
-    
-    // Capture diagonally
-    if (abs(to.col - from.col) == 1 && to.row == from.row + direction) {
-        auto targetPiece = board.getPiece(to);
-        return targetPiece != nullptr && targetPiece->getColor() != color;
-    }
-    
-    return false;
-}
-
-// Rook move validation
-bool Rook::isValidMove(Position from, Position to, Board& board) const {
-    // Must move in straight line (same row or column)
-    if (from.row != to.row && from.col != to.col) return false;
-    
-    // Check if path is clear
-    if (!board.isPathClear(from, to)) return false;
-    
-    // Check destination
-    auto targetPiece = board.getPiece(to);
-    return targetPiece == nullptr || targetPiece->getColor() != color;
-}
-
-// Knight move validation
-bool Knight::isValidMove(Position from, Position to, Board& board) const {
-    int rowDiff = abs(to.row - from.row);
-    int colDiff = abs(to.col - from.col);
-    
-    // L-shape: 2 squares in one direction, 1 in the other
-    if (!((rowDiff == 2 && colDiff == 1) || (rowDiff == 1 && colDiff == 2))) {
-        return false;
-    }
-    
-    // Check destination
-    auto targetPiece = board.getPiece(to);
-    return targetPiece == nullptr || targetPiece->getColor() != color;
-}
-
-// Bishop move validation
-bool Bishop::isValidMove(Position from, Position to, Board& board) const {
-    // Must move diagonally
-    if (abs(to.row - from.row) != abs(to.col - from.col)) return false;
-    
-    // Check if path is clear
-    if (!board.isPathClear(from, to)) return false;
-    
-    // Check destination
-    auto targetPiece = board.getPiece(to);
-    return targetPiece == nullptr || targetPiece->getColor() != color;
-}
-
-// Queen move validation (combines rook and bishop)
-bool Queen::isValidMove(Position from, Position to, Board& board) const {
-    // Must move in straight line or diagonally
-    bool straightLine = (from.row == to.row || from.col == to.col);
-    bool diagonal = (abs(to.row - from.row) == abs(to.col - from.col));
-    
-    if (!straightLine && !diagonal) return false;
-    
-    // Check if path is clear
-    if (!board.isPathClear(from, to)) return false;
-    
-    // Check destination
-    auto targetPiece = board.getPiece(to);
-    return targetPiece == nullptr || targetPiece->getColor() != color;
-}
-
-// King move validation
-bool King::isValidMove(Position from, Position to, Board& board) const {
-    int rowDiff = abs(to.row - from.row);
-    int colDiff = abs(to.col - from.col);
-    
-    // Can only move one square in any direction
-    if (rowDiff > 1 || colDiff > 1) return false;
-    
-    // Check destination
-    auto targetPiece = board.getPiece(to);
-    return targetPiece == nullptr || targetPiece->getColor() != color;
-}
-
-// ============= GAME CLASS IMPLEMENTATIONS =============
-
-// Make a move
-bool Game::makeMove(Position from, Position to) {
-    auto piece = board.getPiece(from);
-    
-    // Check if there's a piece at source
-    if (!piece) return false;
-    
-    // Check if it's the correct player's turn
-    if (piece->getColor() != currentPlayer) return false;
-    
-    // Check if move is valid
-    if (!piece->isValidMove(from, to, board)) return false;
-    
-    // Capture piece if present
-    auto capturedPiece = board.getPiece(to);
-    
-    // Make the move
-    board.setPiece(to, piece);
-    board.setPiece(from, nullptr);
-    piece->setHasMoved(true);
-    
-    // Record move in history
-    Move move(from, to);
-    move.capturedPiece = capturedPiece;
-    moveHistory.push_back(move);
-    
-    // Switch player
-    switchPlayer();
-    
-    return true;
-}
-
-// Validate move (simplified version)
-bool Game::isValidMove(Position from, Position to) const {
-    auto piece = board.getPiece(from);
-    if (!piece) return false;
-    if (piece->getColor() != currentPlayer) return false;
-    return piece->isValidMove(from, to, const_cast<Board&>(board));
-}
+// ============= CHESS GUI IMPLEMENTATIONS =============
 
-// Check if king is in check (simplified - returns false for now)
-bool Game::isInCheck(Color color) const {
-    // TODO: Implement check detection
-    return false;
+void ChessGUI::setGame(Game* g) {
+    game = g;
 }
 
-// Check if checkmate (simplified - returns false for now)
-bool Game::isCheckmate(Color color) const {
-    // TODO: Implement checkmate detection
-    return false;
+void ChessGUI::setSearch(Search* s) {
+    search = s;
 }
 
-// Check if stalemate (simplified - returns false for now)
-bool Game::isStalemate(Color color) const {
-    // TODO: Implement stalemate detection
-    return false;
+void ChessGUI::setBook(const OpeningBook* b) {
+    book = b;
 }
 
-// Undo last move
-void Game::undoMove() {
-    if (moveHistory.empty()) return;
-    
-    Move lastMove = moveHistory.back();
-    moveHistory.pop_back();
-    
-    auto piece = board.getPiece(lastMove.to);
-    board.setPiece(lastMove.from, piece);
-    board.setPiece(lastMove.to, lastMove.capturedPiece);
-    
-    switchPlayer();
+void ChessGUI::setPlayerColor(Color color) {
+    playerColor = color;
+    aiColor = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
 }
 
-// ============= CHESS GUI IMPLEMENTATIONS =============
-
-void ChessGUI::setGame(Game* g) {
-    game = g;
+void ChessGUI::setAIMoveTime(int milliseconds) {
+    aiMoveTimeMs = milliseconds;
+    aiClockMs = 0;
 }
 
-void ChessGUI::setPlayerColor(Color color) {
-    playerColor = color;
-    aiColor = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+void ChessGUI::setAIClock(int milliseconds, int incrementMs) {
+    aiClockMs = milliseconds;
+    aiIncrementMs = incrementMs;
 }
 
 void ChessGUI::run() {
     while (window.isOpen()) {
         handleEvents();
 
-        // Make AI move if it's AI's turn
-        if (state == GameState::PLAYING && game && game->getCurrentPlayer() == aiColor && !isAITurn) {
-            isAITurn = true;
-            makeAIMove();
-            isAITurn = false;
+        // Start the AI on its turn, or pick up its move once it has one
+        if (state == GameState::PLAYING && game) {
+            if (aiThinking) {
+                pollAIMove();
+            } else if (game->getCurrentPlayer() == aiColor) {
+                startAIMove();
+            }
         }
 
         render();
     }
+    cancelAIMove();
+}
+
+// Stop any search before the window goes away
+void ChessGUI::closeWindow() {
+    cancelAIMove();
+    window.close();
 }
 
 void ChessGUI::handleEvents() {
     while (auto event = window.pollEvent()) {
         if (event->is<sf::Event::Closed>()) {
-            window.close();
+            closeWindow();
         }
 
         if (auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
             if (mousePressed->button == sf::Mouse::Button::Left) {
                 if (state == GameState::MENU) {
                     handleMenuClick(mousePressed->position.x, mousePressed->position.y);
-                } else if (state == GameState::PLAYING) {
+                } else {
                     handleMouseClick(mousePressed->position.x, mousePressed->position.y);
                 }
             }
@@ -651,12 +201,11 @@ void ChessGUI::handleMenuClick(int x, int y) {
     else if (x >= 340 && x <= 540 && y >= 250 && y <= 330) {
         setPlayerColor(Color::BLACK);
         state = GameState::PLAYING;
-        isAITurn = true; // AI (white) goes first
         std::cout << "Player chose BLACK\n";
     }
     // Exit button: x from 220-420, y from 380-460
     else if (x >= 220 && x <= 420 && y >= 380 && y <= 460) {
-        window.close();
+        closeWindow();
         std::cout << "Game closed\n";
     }
 }
@@ -667,14 +216,14 @@ void ChessGUI::handleMouseClick(int x, int y) {
     // Check if exit button was clicked (in status bar area)
     if (y >= WINDOW_SIZE) {
         if (x >= WINDOW_SIZE - 140 && x <= WINDOW_SIZE - 20 && y >= WINDOW_SIZE + 25 && y <= WINDOW_SIZE + 75) {
-            window.close();
+            closeWindow();
             std::cout << "Game closed\n";
             return;
         }
     }
 
-    // Only allow player to move on their turn
-    if (game->getCurrentPlayer() != playerColor) return;
+    // Only allow player to move on their turn, while the game is running
+    if (state != GameState::PLAYING || game->getCurrentPlayer() != playerColor) return;
 
     int col = x / SQUARE_SIZE;
     int row = y / SQUARE_SIZE;
@@ -684,8 +233,8 @@ void ChessGUI::handleMouseClick(int x, int y) {
 
     if (!pieceSelected) {
         // Try to select a piece
-        auto piece = game->getPieceAt(clickedPos);
-        if (piece && piece->getColor() == playerColor) {
+        PieceCode piece = game->getPieceAt(clickedPos);
+        if (piece != NO_PIECE && colorOf(piece) == playerColor) {
             pieceSelected = true;
             selectedPos = clickedPos;
             calculateValidMoves();
@@ -696,6 +245,7 @@ void ChessGUI::handleMouseClick(int x, int y) {
         if (game->makeMove(selectedPos, clickedPos)) {
             std::cout << "Moved piece from (" << selectedPos.row << ", " << selectedPos.col
                      << ") to (" << clickedPos.row << ", " << clickedPos.col << ")\n";
+            checkGameOver();
         } else {
             std::cout << "Invalid move\n";
         }
@@ -704,118 +254,105 @@ void ChessGUI::handleMouseClick(int x, int y) {
     }
 }
 
+// Switch to GAME_OVER once the side to move is mated or stalemated, or
+// the game has as many moves as it can hold
+void ChessGUI::checkGameOver() {
+    Color toMove = game->getCurrentPlayer();
+    if (game->isCheckmate(toMove)) {
+        resultText = "Checkmate! ";
+        resultText += (toMove == Color::WHITE) ? "BLACK wins" : "WHITE wins";
+    } else if (game->isStalemate(toMove)) {
+        resultText = "Stalemate - draw";
+    } else if (game->getPlyCount() >= MAX_GAME_PLIES) {
+        resultText = "Move limit reached - draw";
+    } else {
+        return;
+    }
+
+    state = GameState::GAME_OVER;
+    std::cout << resultText << "\n";
+}
+
 void ChessGUI::calculateValidMoves() {
     validMoves.clear();
     if (!game) return;
 
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position testPos(row, col);
-            if (game->isValidMove(selectedPos, testPos)) {
-                validMoves.push_back(testPos);
-            }
+    // Drain every stage of the picker to list all legal moves
+    MovePicker picker(*game);
+    int from = toSquare(selectedPos);
+    Move move;
+    while (picker.next(move)) {
+        // One highlight per square, even though a pawn can promote four ways
+        if (move.from() == from && (move.type() != MoveType::PROMOTION || move.promotion() == PieceType::QUEEN)) {
+            validMoves.push_back(move.toPos());
         }
     }
 }
 
-void ChessGUI::makeAIMove() {
-    if (!game) return;
+// Play a book move at once, or search a snapshot of the game on a
+// worker thread
+void ChessGUI::startAIMove() {
+    // Like Game::makeMove(from, to), never play past MAX_GAME_PLIES
+    if (!game || !search || game->getPlyCount() >= MAX_GAME_PLIES) return;
 
-    // Helper function to get piece value
-    auto getPieceValue = [](PieceType type) -> int {
-        switch (type) {
-            case PieceType::PAWN: return 10;
-            case PieceType::KNIGHT: return 30;
-            case PieceType::BISHOP: return 30;
-            case PieceType::ROOK: return 50;
-            case PieceType::QUEEN: return 90;
-            case PieceType::KING: return 900;
-            default: return 0;
-        }
-    };
-
-    // Helper function to evaluate position control (center control bonus)
-    auto getPositionValue = [](Position pos) -> int {
-        int centerBonus = 0;
-        // Reward center control
-        if ((pos.row >= 3 && pos.row <= 4) && (pos.col >= 3 && pos.col <= 4)) {
-            centerBonus = 5;
-        } else if ((pos.row >= 2 && pos.row <= 5) && (pos.col >= 2 && pos.col <= 5)) {
-            centerBonus = 2;
-        }
-        return centerBonus;
-    };
-
-    // Advanced AI: evaluate moves and pick the best one
-    std::vector<std::pair<Position, Position>> possibleMoves;
-    std::vector<int> moveScores;
-
-    for (int fromRow = 0; fromRow < 8; fromRow++) {
-        for (int fromCol = 0; fromCol < 8; fromCol++) {
-            Position from(fromRow, fromCol);
-            auto piece = game->getPieceAt(from);
-
-            if (piece && piece->getColor() == aiColor) {
-                for (int toRow = 0; toRow < 8; toRow++) {
-                    for (int toCol = 0; toCol < 8; toCol++) {
-                        Position to(toRow, toCol);
-                        if (game->isValidMove(from, to)) {
-                            possibleMoves.push_back({from, to});
-
-                            // Calculate move score
-                            int score = 0;
-
-                            // Check if move captures an enemy piece
-                            auto targetPiece = game->getPieceAt(to);
-                            if (targetPiece && targetPiece->getColor() != aiColor) {
-                                score += getPieceValue(targetPiece->getType());
-                            }
-
-                            // Add position value bonus
-                            score += getPositionValue(to);
-
-                            // Bonus for developing pieces (moving from starting row)
-                            int startRow = (aiColor == Color::WHITE) ? 0 : 7;
-                            if (from.row == startRow) {
-                                score += 3;
-                            }
-
-                            // Pawn advancement bonus
-                            if (piece->getType() == PieceType::PAWN) {
-                                int direction = (aiColor == Color::WHITE) ? 1 : -1;
-                                int advancement = (to.row - from.row) * direction;
-                                score += advancement * 2;
-                            }
-
-                            moveScores.push_back(score);
-                        }
-                    }
-                }
-            }
-        }
+    Move bookMove = book ? book->pick(*game, bookRandom.next()) : Move();
+    if (bookMove != Move()) {
+        game->makeMove(bookMove);
+        std::cout << "AI moved from (" << bookMove.fromPos().row << ", " << bookMove.fromPos().col
+                  << ") to (" << bookMove.toPos().row << ", " << bookMove.toPos().col << ") [book]\n";
+        checkGameOver();
+        return;
     }
 
-    if (!possibleMoves.empty()) {
-        // Find the best move(s)
-        int maxScore = *std::max_element(moveScores.begin(), moveScores.end());
+    SearchLimits limits;
+    if (aiClockMs > 0) {
+        limits.time[toIndex(aiColor)] = aiClockMs;
+        limits.increment[toIndex(aiColor)] = aiIncrementMs;
+    } else {
+        limits.movetime = aiMoveTimeMs;
+    }
 
-        // Collect all moves with the maximum score
-        std::vector<std::pair<Position, Position>> bestMoves;
-        for (size_t i = 0; i < possibleMoves.size(); i++) {
-            if (moveScores[i] == maxScore) {
-                bestMoves.push_back(possibleMoves[i]);
-            }
-        }
+    aiThinking = true;
+    aiResultReady.store(false, std::memory_order_relaxed);
+    search->arm(false);
+    aiThread = std::thread([this, position = *game, limits] {
+        aiResult = search->think(position, limits);
+        aiResultReady.store(true, std::memory_order_release);
+    });
+}
+
+// Play the AI's move once the search has finished
+void ChessGUI::pollAIMove() {
+    if (!aiResultReady.load(std::memory_order_acquire)) return;
 
-        // Pick randomly among the best moves
-        int randomIndex = rand() % bestMoves.size();
-        auto move = bestMoves[randomIndex];
+    aiThread.join();
+    aiThinking = false;
 
-        game->makeMove(move.first, move.second);
-        std::cout << "AI moved from (" << move.first.row << ", " << move.first.col
-                 << ") to (" << move.second.row << ", " << move.second.col << ")"
-                 << " [Score: " << maxScore << "]\n";
+    if (aiClockMs > 0) {
+        aiClockMs = std::max<int>(aiClockMs - static_cast<int>(aiResult.timeMs), 1) + aiIncrementMs;
     }
+
+    // No move means the position had no legal moves
+    if (aiResult.bestMove == Move() || game->getPlyCount() >= MAX_GAME_PLIES) return;
+
+    Move move = aiResult.bestMove;
+    game->makeMove(move);
+    std::cout << "AI moved from (" << move.fromPos().row << ", " << move.fromPos().col
+             << ") to (" << move.toPos().row << ", " << move.toPos().col << ")"
+             << " [Score: " << aiResult.score << ", depth " << aiResult.depth
+             << ", " << aiResult.nodes << " nodes, " << aiResult.timeMs << " ms]\n";
+    checkGameOver();
+}
+
+// Abandon a running search, e.g. on Exit or window close
+void ChessGUI::cancelAIMove() {
+    if (!aiThinking) return;
+
+    // The search was armed before its thread started, so this stop()
+    // holds even if think() has not been reached yet
+    search->stop();
+    aiThread.join();
+    aiThinking = false;
 }
 
 void ChessGUI::render() {
@@ -823,7 +360,7 @@ void ChessGUI::render() {
 
     if (state == GameState::MENU) {
         drawMenu();
-    } else if (state == GameState::PLAYING) {
+    } else {
         drawBoard();
         drawPieces();
         drawStatusBar();
@@ -952,16 +489,16 @@ void ChessGUI::drawPieces() {
     for (int row = 0; row < 8; row++) {
         for (int col = 0; col < 8; col++) {
             Position pos(row, col);
-            auto piece = game->getPieceAt(pos);
+            PieceCode piece = game->getPieceAt(pos);
 
-            if (piece) {
+            if (piece != NO_PIECE) {
                 // SFML 3.0: Text constructor requires font as first parameter
                 sf::Text text(font);
-                text.setString(getPieceUnicode(piece->getType(), piece->getColor()));
+                text.setString(getPieceUnicode(typeOf(piece), colorOf(piece)));
                 text.setCharacterSize(48);
 
                 // White pieces = light color, Black pieces = dark color
-                if (piece->getColor() == Color::WHITE) {
+                if (colorOf(piece) == Color::WHITE) {
                     text.setFillColor(sf::Color(245, 245, 220)); // Beige/cream for white pieces
                     text.setOutlineColor(sf::Color::Black);
                 } else {
@@ -992,10 +529,18 @@ void ChessGUI::drawStatusBar() {
     statusBar.setFillColor(sf::Color(50, 50, 50));
     window.draw(statusBar);
 
-    // Display current turn
+    // Display current turn, or the result once the game has ended
     Color currentPlayer = game->getCurrentPlayer();
     std::string turnText = "Current Turn: ";
     turnText += (currentPlayer == Color::WHITE) ? "WHITE" : "BLACK";
+    if (state == GameState::GAME_OVER) {
+        turnText = resultText;
+    } else if (game->isInCheck(currentPlayer)) {
+        turnText += " (CHECK)";
+    }
+    if (aiThinking) {
+        turnText += "  AI thinking...";
+    }
 
     sf::Text turn(font);
     turn.setString(turnText);
@@ -1010,6 +555,13 @@ void ChessGUI::drawStatusBar() {
     roleText += "  |  AI: ";
     roleText += (aiColor == Color::WHITE) ? "WHITE" : "BLACK";
 
+    // Static evaluation in pawns from White's side
+    int eval = evaluate(*game);
+    if (currentPlayer == Color::BLACK) eval = -eval;
+    char evalText[32];
+    std::snprintf(evalText, sizeof(evalText), "  |  Eval: %+.2f", eval / 100.0);
+    roleText += evalText;
+
     sf::Text role(font);
     role.setString(roleText);
     role.setCharacterSize(24);
@@ -1050,13 +602,60 @@ std::string ChessGUI::getPieceUnicode(PieceType type, Color color) {
     }
 }
 
-int main() {
-    // Seed random number generator for AI
-    srand(static_cast<unsigned int>(time(nullptr)));
+int main(int argc, char* argv[]) {
+    size_t hashMB = 16;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int moveTimeMs = DEFAULT_AI_MOVE_TIME_MS;
+    int clockMs = 0, incrementMs = 0;
+    SearchFeatures features;
+    std::string bookPath;
+    std::string bitbasePath;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--hash") hashMB = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--threads") threads = std::atoi(argv[++i]);
+        else if (arg == "--movetime") moveTimeMs = std::atoi(argv[++i]);
+        else if (arg == "--time") clockMs = std::atoi(argv[++i]);
+        else if (arg == "--inc") incrementMs = std::atoi(argv[++i]);
+        else if (arg == "--book") bookPath = argv[++i];
+        else if (arg == "--bitbases") bitbasePath = argv[++i];
+        else if (arg == "--disable" && !features.set(argv[++i], false)) {
+            std::cerr << "Unknown search feature: " << argv[i] << "\n";
+            return 1;
+        }
+    }
 
     Game game;
+    TranspositionTable tt(hashMB);
+    Search search(tt, threads);
+    search.setFeatures(features);
+
+    std::unique_ptr<OpeningBook> book;
+    if (!bookPath.empty()) {
+        book.reset(new OpeningBook(bookPath));
+        if (!book->isOpen()) {
+            std::cerr << "Cannot read opening book " << bookPath << "\n";
+            return 1;
+        }
+    }
+
+    Bitbases bitbases;
+    if (!bitbasePath.empty()) {
+        int loaded = bitbases.load(bitbasePath);
+        if (loaded == 0) {
+            std::cerr << "No bitbases found in " << bitbasePath << "\n";
+            return 1;
+        }
+        std::cout << loaded << " bitbases loaded from " << bitbasePath << "\n";
+        search.setBitbases(&bitbases);
+    }
+
     ChessGUI gui;
     gui.setGame(&game);
+    gui.setSearch(&search);
+    gui.setBook(book.get());
+    gui.setAIMoveTime(moveTimeMs);
+    if (clockMs > 0) gui.setAIClock(clockMs, incrementMs);
     gui.run();
     return 0;
-}
\ No newline at end of file
+}
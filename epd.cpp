@@ -0,0 +1,175 @@
+// EPD runner: searches every position of a test suite, in parallel across
+// cores, and checks the chosen move against the "bm" (best move) and "am"
+// (avoid move) operations, without SFML.
+//
+//   epd <file> [--nodes n | --movetime ms | --depth n] [--concurrency n] [--hash MB]
+//
+// Each worker owns a single-threaded search and takes the next unsolved
+// position in turn. The default limit is 200000 nodes per position, a
+// fixed workload whose solved count, node total and positions per second
+// are comparable between builds. Positions that fail are listed with the
+// move that was played.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "notation.h"
+#include "search.h"
+
+namespace {
+
+// One suite entry and, once searched, its result
+struct EpdPosition {
+    std::string id;
+    Game game;
+    std::vector<Move> best;
+    std::vector<Move> avoid;
+
+    Move played;
+    uint64_t nodes = 0;
+    bool solved = false;
+};
+
+bool contains(const std::vector<Move>& moves, Move move) {
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+// Parse "<placement> <side> <castling> <ep> op args; op args; ..." with
+// bm and am moves in SAN; false if the line has no position or no test
+bool parseEpd(const std::string& line, EpdPosition& position) {
+    std::istringstream in(line);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        if (!(in >> field)) return false;
+    }
+    if (!position.game.loadFEN(fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3])) return false;
+
+    std::string operation;
+    while (std::getline(in, operation, ';')) {
+        std::istringstream words(operation);
+        std::string opcode, operand;
+        if (!(words >> opcode)) continue;
+
+        if (opcode == "id") {
+            std::getline(words >> std::ws, operand);
+            position.id = operand;
+            position.id.erase(std::remove(position.id.begin(), position.id.end(), '"'), position.id.end());
+        } else if (opcode == "bm" || opcode == "am") {
+            while (words >> operand) {
+                Move move = parseSAN(position.game, operand);
+                if (move == Move()) move = parseMove(position.game, operand);
+                if (move == Move()) return false;
+                (opcode == "bm" ? position.best : position.avoid).push_back(move);
+            }
+        }
+    }
+    return !position.best.empty() || !position.avoid.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SearchLimits limits;
+    limits.nodes = 200000;
+    int concurrency = std::max(1u, std::thread::hardware_concurrency());
+    size_t hashMB = 16;
+    std::string path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--nodes" && hasValue) {
+            limits = SearchLimits();
+            limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--movetime" && hasValue) {
+            limits = SearchLimits();
+            limits.movetime = std::atoi(argv[++i]);
+        } else if (arg == "--depth" && hasValue) {
+            limits = SearchLimits();
+            limits.depth = std::atoi(argv[++i]);
+        } else if (arg == "--concurrency" && hasValue) {
+            concurrency = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--hash" && hasValue) {
+            hashMB = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        } else if (path.empty() && arg.compare(0, 2, "--") != 0) {
+            path = arg;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Usage: epd <file> [--nodes n | --movetime ms | --depth n] [--concurrency n] [--hash MB]\n";
+        return 1;
+    }
+
+    std::vector<EpdPosition> suite;
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); lineNumber++) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        EpdPosition position;
+        if (!parseEpd(line, position)) {
+            std::cerr << path << ":" << lineNumber << ": skipped, no position with a legal bm or am move\n";
+            continue;
+        }
+        if (position.id.empty()) position.id = "line " + std::to_string(lineNumber);
+        suite.push_back(std::move(position));
+    }
+
+    concurrency = std::min<int>(concurrency, std::max<size_t>(suite.size(), 1));
+    std::atomic<size_t> next(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < concurrency; w++) {
+        workers.emplace_back([&] {
+            TranspositionTable tt(hashMB);
+            Search search(tt, 1);
+            for (size_t i; (i = next.fetch_add(1)) < suite.size();) {
+                EpdPosition& position = suite[i];
+                tt.clear();
+                SearchResult result = search.think(position.game, limits);
+                position.played = result.bestMove;
+                position.nodes = result.nodes;
+                position.solved = (position.best.empty() || contains(position.best, result.bestMove))
+                               && !contains(position.avoid, result.bestMove);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t solved = 0;
+    uint64_t nodes = 0;
+    for (const EpdPosition& position : suite) {
+        solved += position.solved;
+        nodes += position.nodes;
+        if (!position.solved) {
+            std::cout << "failed " << position.id << ": played "
+                      << (position.played == Move() ? std::string("none") : moveToSAN(position.game, position.played))
+                      << ", " << (position.best.empty() ? "avoid" : "best");
+            for (const Move& move : position.best.empty() ? position.avoid : position.best) {
+                std::cout << " " << moveToSAN(position.game, move);
+            }
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << "Solved " << solved << " of " << suite.size() << " on " << concurrency << " threads, "
+              << nodes << " nodes in " << std::fixed << std::setprecision(2) << seconds << " s ("
+              << suite.size() / std::max(seconds, 1e-9) << " positions/s, "
+              << static_cast<uint64_t>(nodes / std::max(seconds, 1e-9)) << " nps)\n";
+    return 0;
+}
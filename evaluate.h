@@ -0,0 +1,57 @@
+#pragma once
+
+#include "types.h"
+
+class Game;
+
+// Nominal centipawn piece values, used for move ordering and exchanges
+const int PAWN_VALUE = 100;
+const int KNIGHT_VALUE = 300;
+const int BISHOP_VALUE = 300;
+const int ROOK_VALUE = 500;
+const int QUEEN_VALUE = 900;
+
+// Middlegame and endgame halves of a tapered score
+struct Score {
+    int mg = 0;
+    int eg = 0;
+
+    Score() = default;
+    Score(int middlegame, int endgame) : mg(middlegame), eg(endgame) {}
+
+    Score& operator+=(Score s) { mg += s.mg; eg += s.eg; return *this; }
+    Score& operator-=(Score s) { mg -= s.mg; eg -= s.eg; return *this; }
+    Score operator+(Score s) const { return Score(mg + s.mg, eg + s.eg); }
+    Score operator-(Score s) const { return Score(mg - s.mg, eg - s.eg); }
+    bool operator==(Score s) const { return mg == s.mg && eg == s.eg; }
+    bool operator!=(Score s) const { return !(*this == s); }
+};
+
+// ============= EVALUATION TABLES =============
+
+namespace Eval {
+
+// Game phase of a full set of non-pawn material; 0 is a bare endgame
+const int MAX_PHASE = 24;
+
+// Material plus piece-square bonus for each piece code and square, from
+// White's point of view (Black's entries are negated and mirrored)
+extern Score psq[12][64];
+
+// Contribution of each piece code to the game phase
+extern int phaseWeight[12];
+
+// Fill the tables once (safe to call repeatedly and from any thread)
+void init();
+
+// Blend the two halves of a score by game phase
+inline int taper(Score s, int phase) {
+    if (phase > MAX_PHASE) phase = MAX_PHASE;
+    return (s.mg * phase + s.eg * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+} // namespace Eval
+
+// Static evaluation in centipawns from the side to move's point of view.
+// O(1): reads the score Game keeps up to date in makeMove/undoMove.
+int evaluate(const Game& game);
@@ -0,0 +1,447 @@
+#include "game.h"
+#include "movegen.h"
+#include "bitboard.h"
+#include "zobrist.h"
+
+#include <array>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Castling rights that survive a move touching each square
+const std::array<uint8_t, 64> castlingMask = [] {
+    std::array<uint8_t, 64> mask;
+    mask.fill(WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO);
+    mask[squareOf(0, 4)] &= ~(WHITE_OO | WHITE_OOO);
+    mask[squareOf(0, 7)] &= ~WHITE_OO;
+    mask[squareOf(0, 0)] &= ~WHITE_OOO;
+    mask[squareOf(7, 4)] &= ~(BLACK_OO | BLACK_OOO);
+    mask[squareOf(7, 7)] &= ~BLACK_OO;
+    mask[squareOf(7, 0)] &= ~BLACK_OOO;
+    return mask;
+}();
+
+// Rook squares for a castling move, derived from the king's destination
+void castlingRookSquares(int kingTo, int& rookFrom, int& rookTo) {
+    bool kingSide = fileOf(kingTo) == 6;
+    rookFrom = squareOf(rankOf(kingTo), kingSide ? 7 : 0);
+    rookTo = squareOf(rankOf(kingTo), kingSide ? 5 : 3);
+}
+
+} // namespace
+
+// ============= GAME CLASS IMPLEMENTATIONS =============
+
+Game::Game() {
+    Attacks::init();
+    Zobrist::init();
+    Eval::init();
+    start();
+}
+
+void Game::start() {
+    board.initialize();
+    currentPlayer = Color::WHITE;
+    castlingRights = WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO;
+    epSquare = NO_SQUARE;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    key = computeKey();
+    psq = computePsq();
+    phase = computePhase();
+    moveHistory.clear();
+    gameOver = false;
+}
+
+// Material and piece-square score computed from scratch
+Score Game::computePsq() const {
+    Score s;
+    for (Bitboard b = board.pieces(); b;) {
+        int sq = popLsb(b);
+        s += Eval::psq[board.pieceOn(sq)][sq];
+    }
+    return s;
+}
+
+// Game phase computed from scratch
+int Game::computePhase() const {
+    int p = 0;
+    for (Bitboard b = board.pieces(); b;) {
+        p += Eval::phaseWeight[board.pieceOn(popLsb(b))];
+    }
+    return p;
+}
+
+// Zobrist key of the current position computed from scratch
+uint64_t Game::computeKey() const {
+    uint64_t k = 0;
+    for (Bitboard b = board.pieces(); b;) {
+        int sq = popLsb(b);
+        k ^= Zobrist::psq[board.pieceOn(sq)][sq];
+    }
+    if (epSquare != NO_SQUARE) k ^= Zobrist::enPassant[fileOf(epSquare)];
+    k ^= Zobrist::castling[castlingRights];
+    if (currentPlayer == Color::BLACK) k ^= Zobrist::side;
+    return k;
+}
+
+// True if the position occurred before since the last capture or pawn move
+bool Game::isRepetition() const {
+    // Same side to move, and at least two moves each are needed to come back
+    int end = static_cast<int>(moveHistory.size());
+    int start = end - halfmoveClock;
+    for (int i = end - 4; i >= 0 && i >= start; i -= 2) {
+        if (moveHistory[i].key == key) return true;
+    }
+    return false;
+}
+
+// Set up a position from Forsyth-Edwards Notation
+bool Game::loadFEN(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling, ep;
+    int halfmove = 0, fullmove = 1;
+    if (!(in >> placement >> side)) return false;
+    if (!(in >> castling)) castling = "-";
+    if (!(in >> ep)) ep = "-";
+    if (!(in >> halfmove >> fullmove)) {
+        halfmove = 0;
+        fullmove = 1;
+    }
+
+    Board parsed;
+    int rank = 7, file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) return false;
+            rank--;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return false;
+        } else {
+            const char* symbols = "PRNBQKprnbqk";
+            const char* found = std::char_traits<char>::find(symbols, 12, c);
+            if (!found || file > 7) return false;
+            parsed.putPiece(squareOf(rank, file++), static_cast<PieceCode>(found - symbols));
+        }
+    }
+    if (rank != 0 || file != 8) return false;
+    if (popCount(parsed.pieces(Color::WHITE, PieceType::KING)) != 1
+        || popCount(parsed.pieces(Color::BLACK, PieceType::KING)) != 1) {
+        return false;
+    }
+
+    if (side != "w" && side != "b") return false;
+    Color toMove = (side == "w") ? Color::WHITE : Color::BLACK;
+
+    uint8_t rights = 0;
+    for (char c : castling) {
+        switch (c) {
+            case 'K': rights |= WHITE_OO; break;
+            case 'Q': rights |= WHITE_OOO; break;
+            case 'k': rights |= BLACK_OO; break;
+            case 'q': rights |= BLACK_OOO; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+    // Drop rights whose king or rook is no longer at home
+    for (int sq : { squareOf(0, 0), squareOf(0, 4), squareOf(0, 7), squareOf(7, 0), squareOf(7, 4), squareOf(7, 7) }) {
+        PieceType expected = (fileOf(sq) == 4) ? PieceType::KING : PieceType::ROOK;
+        Color owner = (rankOf(sq) == 0) ? Color::WHITE : Color::BLACK;
+        if (parsed.pieceOn(sq) != makePiece(owner, expected)) rights &= castlingMask[sq];
+    }
+
+    uint8_t epSq = NO_SQUARE;
+    if (ep != "-") {
+        // The square lies behind a pawn the opponent has just pushed
+        char epRank = (toMove == Color::WHITE) ? '6' : '3';
+        if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h' || ep[1] != epRank) return false;
+        int sq = squareOf(ep[1] - '1', ep[0] - 'a');
+        int push = (toMove == Color::WHITE) ? 8 : -8;
+        bool pushed = parsed.pieceOn(sq - push) == makePiece(~toMove, PieceType::PAWN)
+                   && parsed.pieceOn(sq) == NO_PIECE
+                   && parsed.pieceOn(sq + push) == NO_PIECE;
+        // Only keep it if that pawn is there and one of ours can capture it
+        if (pushed && (Attacks::pawn(~toMove, sq) & parsed.pieces(toMove, PieceType::PAWN))) {
+            epSq = static_cast<uint8_t>(sq);
+        }
+    }
+
+    board = parsed;
+    currentPlayer = toMove;
+    castlingRights = rights;
+    epSquare = epSq;
+    halfmoveClock = halfmove;
+    fullmoveNumber = fullmove;
+    key = computeKey();
+    psq = computePsq();
+    phase = computePhase();
+    moveHistory.clear();
+    gameOver = false;
+    return true;
+}
+
+void Game::setup(const Board& position, Color toMove) {
+    board = position;
+    currentPlayer = toMove;
+    castlingRights = 0;
+    epSquare = NO_SQUARE;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    key = computeKey();
+    psq = computePsq();
+    phase = computePhase();
+    moveHistory.clear();
+    gameOver = false;
+}
+
+std::string Game::toFEN() const {
+    std::string fen;
+    fen.reserve(96);
+    for (int rank = 7; rank >= 0; rank--) {
+        int empty = 0;
+        for (int file = 0; file < 8; file++) {
+            PieceCode piece = board.pieceOn(squareOf(rank, file));
+            if (piece == NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty) fen += static_cast<char>('0' + empty);
+            fen += "PRNBQKprnbqk"[piece];
+            empty = 0;
+        }
+        if (empty) fen += static_cast<char>('0' + empty);
+        if (rank) fen += '/';
+    }
+
+    fen += (currentPlayer == Color::WHITE) ? " w " : " b ";
+    if (!castlingRights) fen += '-';
+    if (castlingRights & WHITE_OO) fen += 'K';
+    if (castlingRights & WHITE_OOO) fen += 'Q';
+    if (castlingRights & BLACK_OO) fen += 'k';
+    if (castlingRights & BLACK_OOO) fen += 'q';
+
+    fen += ' ';
+    if (epSquare == NO_SQUARE) {
+        fen += '-';
+    } else {
+        fen += static_cast<char>('a' + fileOf(epSquare));
+        fen += static_cast<char>('1' + rankOf(epSquare));
+    }
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+    return fen;
+}
+
+void Game::play() {
+    board.display();
+    std::cout << "Game loop - implement GUI here\n";
+}
+
+Color Game::getCurrentPlayer() const {
+    return currentPlayer;
+}
+
+void Game::switchPlayer() {
+    currentPlayer = ~currentPlayer;
+}
+
+// Look up the generated move matching a GUI from/to pair
+bool Game::findMove(Position from, Position to, Move& found) const {
+    if (!from.isValid() || !to.isValid()) return false;
+
+    MoveList moves;
+    generateMoves(*this, moves);
+
+    int fromSq = toSquare(from);
+    int toSq = toSquare(to);
+    for (const Move& move : moves) {
+        if (move.from() == fromSq && move.to() == toSq
+            && (move.type() != MoveType::PROMOTION || move.promotion() == PieceType::QUEEN)) {
+            found = move;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Make a move given by board coordinates
+bool Game::makeMove(Position from, Position to) {
+    Move move;
+    if (moveHistory.size() >= MAX_GAME_PLIES || !findMove(from, to, move)) return false;
+    makeMove(move);
+    return true;
+}
+
+// Make a move produced by the move generator
+void Game::makeMove(Move move) {
+    Color us = currentPlayer;
+    PieceCode piece = board.pieceOn(move.from());
+    int captureSq = (move.type() == MoveType::EN_PASSANT) ? move.to() ^ 8 : move.to();
+
+    // Record everything undoMove needs to restore
+    UndoInfo& undo = moveHistory.push();
+    undo.key = key;
+    undo.psq = psq;
+    undo.move = move;
+    undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+    undo.capturedPiece = (move.type() == MoveType::CASTLING) ? NO_PIECE : board.pieceOn(captureSq);
+    undo.castlingRights = castlingRights;
+    undo.epSquare = epSquare;
+    undo.phase = static_cast<uint8_t>(phase);
+
+    halfmoveClock++;
+    key ^= Zobrist::side;
+    if (epSquare != NO_SQUARE) {
+        key ^= Zobrist::enPassant[fileOf(epSquare)];
+        epSquare = NO_SQUARE;
+    }
+
+    if (move.type() == MoveType::CASTLING) {
+        int rookFrom, rookTo;
+        castlingRookSquares(move.to(), rookFrom, rookTo);
+        PieceCode rook = board.pieceOn(rookFrom);
+        key ^= Zobrist::psq[piece][move.from()] ^ Zobrist::psq[piece][move.to()]
+             ^ Zobrist::psq[rook][rookFrom] ^ Zobrist::psq[rook][rookTo];
+        psq += Eval::psq[piece][move.to()] - Eval::psq[piece][move.from()]
+             + Eval::psq[rook][rookTo] - Eval::psq[rook][rookFrom];
+        board.movePiece(move.from(), move.to());
+        board.movePiece(rookFrom, rookTo);
+    } else {
+        if (undo.capturedPiece != NO_PIECE) {
+            key ^= Zobrist::psq[undo.capturedPiece][captureSq];
+            psq -= Eval::psq[undo.capturedPiece][captureSq];
+            phase -= Eval::phaseWeight[undo.capturedPiece];
+            board.removePiece(captureSq);
+            halfmoveClock = 0;
+        }
+        key ^= Zobrist::psq[piece][move.from()] ^ Zobrist::psq[piece][move.to()];
+        psq += Eval::psq[piece][move.to()] - Eval::psq[piece][move.from()];
+        board.movePiece(move.from(), move.to());
+
+        if (typeOf(piece) == PieceType::PAWN) {
+            halfmoveClock = 0;
+
+            // Only record an en passant square an enemy pawn could use
+            if ((move.to() ^ move.from()) == 16) {
+                int passed = (move.from() + move.to()) / 2;
+                if (Attacks::pawn(us, passed) & board.pieces(~us, PieceType::PAWN)) {
+                    epSquare = static_cast<uint8_t>(passed);
+                    key ^= Zobrist::enPassant[fileOf(passed)];
+                }
+            } else if (move.type() == MoveType::PROMOTION) {
+                PieceCode promoted = makePiece(us, move.promotion());
+                key ^= Zobrist::psq[piece][move.to()] ^ Zobrist::psq[promoted][move.to()];
+                psq += Eval::psq[promoted][move.to()] - Eval::psq[piece][move.to()];
+                phase += Eval::phaseWeight[promoted];
+                board.removePiece(move.to());
+                board.putPiece(move.to(), promoted);
+            }
+        }
+    }
+
+    key ^= Zobrist::castling[castlingRights];
+    castlingRights &= castlingMask[move.from()] & castlingMask[move.to()];
+    key ^= Zobrist::castling[castlingRights];
+    if (us == Color::BLACK) fullmoveNumber++;
+
+    // Switch player
+    switchPlayer();
+}
+
+void Game::makeNullMove() {
+    UndoInfo& undo = moveHistory.push();
+    undo.key = key;
+    undo.psq = psq;
+    undo.move = Move();
+    undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+    undo.capturedPiece = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.epSquare = epSquare;
+    undo.phase = static_cast<uint8_t>(phase);
+
+    halfmoveClock = 0;
+    key ^= Zobrist::side;
+    if (epSquare != NO_SQUARE) {
+        key ^= Zobrist::enPassant[fileOf(epSquare)];
+        epSquare = NO_SQUARE;
+    }
+    switchPlayer();
+}
+
+void Game::undoNullMove() {
+    const UndoInfo& undo = moveHistory.back();
+    epSquare = undo.epSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+    moveHistory.pop();
+    switchPlayer();
+}
+
+// Validate move
+bool Game::isValidMove(Position from, Position to) const {
+    Move move;
+    return findMove(from, to, move);
+}
+
+// Check if king is in check
+bool Game::isInCheck(Color color) const {
+    int king = board.kingSquare(color);
+    return board.attackersTo(king, board.pieces()) & board.pieces(~color);
+}
+
+// True if the side to move has at least one legal move
+bool Game::hasLegalMoves() const {
+    MoveList moves;
+    generateMoves(*this, moves);
+    return !moves.empty();
+}
+
+// Check if king is in checkmate (only the side to move can be mated)
+bool Game::isCheckmate(Color color) const {
+    return color == currentPlayer && isInCheck(color) && !hasLegalMoves();
+}
+
+// Check if game is stalemate
+bool Game::isStalemate(Color color) const {
+    return color == currentPlayer && !isInCheck(color) && !hasLegalMoves();
+}
+
+// Undo last move
+void Game::undoMove() {
+    if (moveHistory.empty()) return;
+
+    const UndoInfo& undo = moveHistory.back();
+    switchPlayer();
+    Color us = currentPlayer;
+    const Move& move = undo.move;
+
+    if (move.type() == MoveType::CASTLING) {
+        int rookFrom, rookTo;
+        castlingRookSquares(move.to(), rookFrom, rookTo);
+        board.movePiece(rookTo, rookFrom);
+        board.movePiece(move.to(), move.from());
+    } else {
+        if (move.type() == MoveType::PROMOTION) {
+            board.removePiece(move.to());
+            board.putPiece(move.to(), makePiece(us, PieceType::PAWN));
+        }
+        board.movePiece(move.to(), move.from());
+
+        if (undo.capturedPiece != NO_PIECE) {
+            int captureSq = (move.type() == MoveType::EN_PASSANT) ? move.to() ^ 8 : move.to();
+            board.putPiece(captureSq, undo.capturedPiece);
+        }
+    }
+
+    castlingRights = undo.castlingRights;
+    epSquare = undo.epSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+    psq = undo.psq;
+    phase = undo.phase;
+    moveHistory.pop();
+    if (us == Color::BLACK) fullmoveNumber--;
+}
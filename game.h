@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include "board.h"
+#include "evaluate.h"
+
+enum class MoveType : uint8_t {
+    NORMAL, PROMOTION, EN_PASSANT, CASTLING
+};
+
+// Move packed into 16 bits: from 6 | to 6 | type 2 | promotion 2, where
+// the promotion bits count from the rook (castling is encoded as the
+// king's two-square step). The null Move() is a1a1.
+class Move {
+private:
+    uint16_t data;
+
+public:
+    Move() : data(0) {}
+    Move(int f, int t, MoveType mt = MoveType::NORMAL, PieceType promo = PieceType::NONE)
+        : data(static_cast<uint16_t>(f | (t << 6) | (static_cast<int>(mt) << 12)
+               | ((mt == MoveType::PROMOTION ? toIndex(promo) - 1 : 0) << 14))) {}
+
+    // The packed form, e.g. for the transposition table
+    static Move fromRaw(uint16_t raw) {
+        Move move;
+        move.data = raw;
+        return move;
+    }
+    uint16_t raw() const { return data; }
+
+    int from() const { return data & 63; }
+    int to() const { return (data >> 6) & 63; }
+    MoveType type() const { return static_cast<MoveType>((data >> 12) & 3); }
+    PieceType promotion() const {
+        return type() == MoveType::PROMOTION ? static_cast<PieceType>((data >> 14) + 1) : PieceType::NONE;
+    }
+
+    Position fromPos() const { return toPosition(from()); }
+    Position toPos() const { return toPosition(to()); }
+
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+};
+
+// Castling rights bit flags
+const uint8_t WHITE_OO = 1;
+const uint8_t WHITE_OOO = 2;
+const uint8_t BLACK_OO = 4;
+const uint8_t BLACK_OOO = 8;
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// State that a move destroys and undoMove must restore (24 bytes, POD)
+struct UndoInfo {
+    uint64_t key;
+    Score psq;
+    Move move;
+    uint16_t halfmoveClock;
+    PieceCode capturedPiece;
+    uint8_t castlingRights;
+    uint8_t epSquare;
+    uint8_t phase;
+};
+
+// Longest game Game accepts through its validated makeMove, and plies kept
+// free above it on the undo stack for a search line (at least MAX_PLY)
+const int MAX_GAME_PLIES = 2048;
+const int SEARCH_PLY_RESERVE = 256;
+
+// Fixed-capacity stack of undo records, so making and unmaking moves never
+// allocates. Copies take only the records in use.
+class UndoStack {
+private:
+    static const int CAPACITY = MAX_GAME_PLIES + SEARCH_PLY_RESERVE;
+
+    UndoInfo records[CAPACITY];
+    int count;
+
+public:
+    UndoStack() : count(0) {}
+    UndoStack(const UndoStack& other) : count(other.count) {
+        std::copy(other.records, other.records + count, records);
+    }
+    UndoStack& operator=(const UndoStack& other) {
+        count = other.count;
+        std::copy(other.records, other.records + count, records);
+        return *this;
+    }
+
+    // The caller keeps the stack within MAX_GAME_PLIES + SEARCH_PLY_RESERVE
+    UndoInfo& push() {
+        assert(count < CAPACITY);
+        return records[count++];
+    }
+    void pop() { count--; }
+    void clear() { count = 0; }
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    const UndoInfo& back() const { return records[count - 1]; }
+    const UndoInfo& operator[](int i) const { return records[i]; }
+};
+
+// Game class - manages the game state
+class Game {
+private:
+    Board board;
+    Color currentPlayer;
+    uint8_t castlingRights;
+    uint8_t epSquare;
+    int halfmoveClock;
+    int fullmoveNumber;
+    uint64_t key;
+    Score psq;
+    int phase;
+    UndoStack moveHistory;
+    bool gameOver;
+
+    // Look up the generated move matching a GUI from/to pair
+    bool findMove(Position from, Position to, Move& found) const;
+
+public:
+    Game();
+
+    // Start the game
+    void start();
+
+    // Set up a position from Forsyth-Edwards Notation (unchanged on error)
+    bool loadFEN(const std::string& fen);
+
+    // The position in Forsyth-Edwards Notation
+    std::string toFEN() const;
+
+    // Set up pieces with the given side to move and no castling rights, en
+    // passant square or history (endgame table generation and probing)
+    void setup(const Board& position, Color toMove);
+
+    // Make a move given by board coordinates (validated; promotes to a queen).
+    // Fails once the game is MAX_GAME_PLIES long.
+    bool makeMove(Position from, Position to);
+
+    // Make a move produced by the move generator (not validated)
+    void makeMove(Move move);
+
+    // Pass the turn without moving (search only; never while in check).
+    // Repetitions are not looked for across a null move.
+    void makeNullMove();
+    void undoNullMove();
+
+    // Validate move
+    bool isValidMove(Position from, Position to) const;
+
+    // Check if king is in check
+    bool isInCheck(Color color) const;
+
+    // Check if king is in checkmate
+    bool isCheckmate(Color color) const;
+
+    // Check if game is stalemate
+    bool isStalemate(Color color) const;
+
+    // True if the side to move has at least one legal move
+    bool hasLegalMoves() const;
+
+    // Switch player turn
+    void switchPlayer();
+
+    // Get current player
+    Color getCurrentPlayer() const;
+
+    // Get piece at position
+    PieceCode getPieceAt(Position pos) const { return board.getPiece(pos); }
+
+    // Read-only access to the bitboard position
+    const Board& getBoard() const { return board; }
+
+    // Irreversible state used by move generation
+    uint8_t getCastlingRights() const { return castlingRights; }
+    int getEpSquare() const { return epSquare; }
+    int getHalfmoveClock() const { return halfmoveClock; }
+
+    // Zobrist key, maintained incrementally by makeMove/undoMove
+    uint64_t getKey() const { return key; }
+
+    // Zobrist key of the current position computed from scratch
+    uint64_t computeKey() const;
+
+    // Material and piece-square score (White's view) and game phase,
+    // maintained incrementally by makeMove/undoMove
+    Score getPsq() const { return psq; }
+    int getPhase() const { return phase; }
+
+    // The same two computed from scratch
+    Score computePsq() const;
+    int computePhase() const;
+
+    // True if the position occurred before since the last capture or pawn move
+    bool isRepetition() const;
+
+    // True if the move takes a piece (including en passant)
+    bool isCapture(Move move) const {
+        return move.type() == MoveType::EN_PASSANT
+            || (move.type() != MoveType::CASTLING && board.pieceOn(move.to()) != NO_PIECE);
+    }
+
+    // Moves played since the game was started or loaded
+    int getPlyCount() const { return moveHistory.size(); }
+
+    // The move that led to this position (a null Move at the root)
+    Move getLastMove() const { return moveHistory.empty() ? Move() : moveHistory.back().move; }
+
+    // Game loop
+    void play();
+
+    // Undo last move
+    void undoMove();
+};
@@ -0,0 +1,30 @@
+#include "mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path, Access access) : bytes(nullptr), length(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        if (info.st_size == 0) {
+            bytes = "";
+        } else {
+            void* mem = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mem != MAP_FAILED) {
+                madvise(mem, info.st_size, access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+                bytes = static_cast<const char*>(mem);
+                length = info.st_size;
+            }
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (length) munmap(const_cast<char*>(bytes), length);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory map of a whole file; empty if it cannot be opened
+class MappedFile {
+public:
+    // How the file will be read, passed on to the kernel's read-ahead:
+    // front to back (PGN) or by scattered lookups (books, bitbases)
+    enum class Access { SEQUENTIAL, RANDOM };
+
+private:
+    const char* bytes;
+    size_t length;
+
+public:
+    MappedFile(const std::string& path, Access access);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return bytes != nullptr; }
+    std::string_view text() const { return std::string_view(bytes, length); }
+    const unsigned char* data() const { return reinterpret_cast<const unsigned char*>(bytes); }
+    size_t size() const { return length; }
+};
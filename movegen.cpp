@@ -0,0 +1,337 @@
+#include "movegen.h"
+#include "bitboard.h"
+
+// Generation and legality checks are templated on the side to move and the
+// piece type, so color tests and per-piece dispatch fold away at compile
+// time; the public functions pick the instantiation once per call.
+
+namespace {
+
+// Check and pin information shared by every piece's generator
+struct LegalityInfo {
+    int king;
+    Bitboard checkers;
+    Bitboard pinned;
+    Bitboard checkMask;   // squares that capture or block every checker
+};
+
+template <Color Us>
+LegalityInfo computeLegality(const Board& board) {
+    constexpr Color Them = ~Us;
+    LegalityInfo info;
+    Bitboard occupied = board.pieces();
+
+    info.king = board.kingSquare(Us);
+    info.checkers = board.attackersTo(info.king, occupied) & board.pieces(Them);
+    info.pinned = 0;
+
+    // Enemy sliders that would hit the king through exactly one own piece
+    Bitboard snipers = (Attacks::rook(info.king, 0) & (board.pieces(Them, PieceType::ROOK) | board.pieces(Them, PieceType::QUEEN)))
+                     | (Attacks::bishop(info.king, 0) & (board.pieces(Them, PieceType::BISHOP) | board.pieces(Them, PieceType::QUEEN)));
+    while (snipers) {
+        Bitboard blockers = Attacks::between(info.king, popLsb(snipers)) & occupied;
+        if (popCount(blockers) == 1) info.pinned |= blockers & board.pieces(Us);
+    }
+
+    if (!info.checkers) {
+        info.checkMask = ~Bitboard(0);
+    } else if (popCount(info.checkers) == 1) {
+        info.checkMask = Attacks::between(info.king, lsb(info.checkers)) | info.checkers;
+    } else {
+        info.checkMask = 0;
+    }
+    return info;
+}
+
+// Pinned pieces may only move along the line through their king
+Bitboard pinRestriction(const LegalityInfo& info, int from) {
+    return (info.pinned & squareBB(from)) ? Attacks::line(info.king, from) : ~Bitboard(0);
+}
+
+// Add one move per target square, all starting from the same square
+void addMoves(MoveList& moves, int from, Bitboard targets) {
+    while (targets) {
+        moves.emplace_back(from, popLsb(targets));
+    }
+}
+
+// Add promotions onto a square, split between CAPTURES and QUIETS
+void addPromotions(MoveList& moves, int from, int to, GenType type, bool capture) {
+    if (type != GenType::QUIETS) {
+        moves.emplace_back(from, to, MoveType::PROMOTION, PieceType::QUEEN);
+    }
+    if (type == GenType::ALL || (type == GenType::CAPTURES) == capture) {
+        moves.emplace_back(from, to, MoveType::PROMOTION, PieceType::ROOK);
+        moves.emplace_back(from, to, MoveType::PROMOTION, PieceType::BISHOP);
+        moves.emplace_back(from, to, MoveType::PROMOTION, PieceType::KNIGHT);
+    }
+}
+
+// Squares a piece of the given type and side reaches from a square,
+// ignoring checks and pins: pawn pushes onto empty squares and captures of
+// enemy pieces, or attacks onto anything but an own piece
+template <PieceType Pt, Color Us>
+Bitboard reach(const Board& board, int from) {
+    Bitboard occupied = board.pieces();
+    if constexpr (Pt == PieceType::PAWN) {
+        constexpr Bitboard doublePushRank = (Us == Color::WHITE) ? RANK_3 : RANK_6;
+        Bitboard single = pawnPush(Us, squareBB(from)) & ~occupied;
+        Bitboard dbl = pawnPush(Us, single & doublePushRank) & ~occupied;
+        return single | dbl | (Attacks::pawn(Us, from) & board.pieces(~Us));
+    } else {
+        return Attacks::of<Pt>(from, occupied) & ~board.pieces(Us);
+    }
+}
+
+// En passant is legal unless removing both pawns exposes the king
+template <Color Us>
+bool enPassantIsLegal(const Board& board, const LegalityInfo& info, int from, int to) {
+    constexpr Color Them = ~Us;
+    int captured = to ^ 8;
+    if (!(info.checkMask & (squareBB(to) | squareBB(captured)))) return false;
+
+    Bitboard occupied = (board.pieces() ^ squareBB(from) ^ squareBB(captured)) | squareBB(to);
+    Bitboard rooks = board.pieces(Them, PieceType::ROOK) | board.pieces(Them, PieceType::QUEEN);
+    Bitboard bishops = board.pieces(Them, PieceType::BISHOP) | board.pieces(Them, PieceType::QUEEN);
+    return !(Attacks::rook(info.king, occupied) & rooks) && !(Attacks::bishop(info.king, occupied) & bishops);
+}
+
+template <Color Us>
+void generatePawnMoves(const Game& game, const LegalityInfo& info, MoveList& moves, GenType type) {
+    constexpr Color Them = ~Us;
+    constexpr Bitboard lastRank = (Us == Color::WHITE) ? RANK_8 : RANK_1;
+    constexpr Bitboard doublePushRank = (Us == Color::WHITE) ? RANK_3 : RANK_6;
+
+    // Square offsets back to the origin of each pawn step
+    constexpr int up = (Us == Color::WHITE) ? 8 : -8;
+    constexpr int west = up - 1;
+    constexpr int east = up + 1;
+
+    const Board& board = game.getBoard();
+    Bitboard pawns = board.pieces(Us, PieceType::PAWN);
+    Bitboard empty = ~board.pieces();
+    Bitboard enemies = board.pieces(Them);
+
+    Bitboard push = pawnPush(Us, pawns) & empty;
+    Bitboard dbl = pawnPush(Us, push & doublePushRank) & empty & info.checkMask;
+    push &= info.checkMask;
+    Bitboard westCaptures = pawnAttacksWest(Us, pawns) & enemies & info.checkMask;
+    Bitboard eastCaptures = pawnAttacksEast(Us, pawns) & enemies & info.checkMask;
+
+    auto allowed = [&](int from, int to) {
+        return pinRestriction(info, from) & squareBB(to);
+    };
+
+    if (type != GenType::CAPTURES) {
+        for (Bitboard b = push & ~lastRank; b;) {
+            int to = popLsb(b);
+            if (allowed(to - up, to)) moves.emplace_back(to - up, to);
+        }
+        while (dbl) {
+            int to = popLsb(dbl);
+            if (allowed(to - 2 * up, to)) moves.emplace_back(to - 2 * up, to);
+        }
+    }
+
+    // Promotions
+    for (Bitboard b = push & lastRank; b;) {
+        int to = popLsb(b);
+        if (allowed(to - up, to)) addPromotions(moves, to - up, to, type, false);
+    }
+    for (Bitboard b = westCaptures & lastRank; b;) {
+        int to = popLsb(b);
+        if (allowed(to - west, to)) addPromotions(moves, to - west, to, type, true);
+    }
+    for (Bitboard b = eastCaptures & lastRank; b;) {
+        int to = popLsb(b);
+        if (allowed(to - east, to)) addPromotions(moves, to - east, to, type, true);
+    }
+
+    if (type == GenType::QUIETS) return;
+
+    // Ordinary captures
+    for (Bitboard b = westCaptures & ~lastRank; b;) {
+        int to = popLsb(b);
+        if (allowed(to - west, to)) moves.emplace_back(to - west, to);
+    }
+    for (Bitboard b = eastCaptures & ~lastRank; b;) {
+        int to = popLsb(b);
+        if (allowed(to - east, to)) moves.emplace_back(to - east, to);
+    }
+
+    // En passant
+    int ep = game.getEpSquare();
+    if (ep != NO_SQUARE) {
+        for (Bitboard b = Attacks::pawn(Them, ep) & pawns; b;) {
+            int from = popLsb(b);
+            if (enPassantIsLegal<Us>(board, info, from, ep)) {
+                moves.emplace_back(from, ep, MoveType::EN_PASSANT);
+            }
+        }
+    }
+}
+
+// Knight, bishop, rook and queen moves; pinned knights can never move
+template <Color Us, PieceType Pt>
+void generatePieceMoves(const Board& board, const LegalityInfo& info, MoveList& moves, Bitboard targets) {
+    Bitboard pieces = board.pieces(Us, Pt);
+    if constexpr (Pt == PieceType::KNIGHT) pieces &= ~info.pinned;
+
+    Bitboard occupied = board.pieces();
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard attacks = Attacks::of<Pt>(from, occupied) & targets;
+        if constexpr (Pt != PieceType::KNIGHT) attacks &= pinRestriction(info, from);
+        addMoves(moves, from, attacks);
+    }
+}
+
+// Castling for the side to move; every square the king crosses must be safe
+template <Color Us>
+void generateCastling(const Game& game, MoveList& moves) {
+    constexpr uint8_t ownRights = (Us == Color::WHITE) ? WHITE_OO | WHITE_OOO : BLACK_OO | BLACK_OOO;
+    constexpr int rank = (Us == Color::WHITE) ? 0 : 7;
+
+    const Board& board = game.getBoard();
+    uint8_t rights = game.getCastlingRights() & ownRights;
+    if (!rights) return;
+
+    int kingFrom = squareOf(rank, 4);
+    Bitboard occupied = board.pieces();
+    Bitboard enemies = board.pieces(~Us);
+
+    auto safe = [&](int sq) { return !(board.attackersTo(sq, occupied) & enemies); };
+
+    if ((rights & (WHITE_OO | BLACK_OO))
+        && !(occupied & (squareBB(squareOf(rank, 5)) | squareBB(squareOf(rank, 6))))
+        && safe(squareOf(rank, 5)) && safe(squareOf(rank, 6))) {
+        moves.emplace_back(kingFrom, squareOf(rank, 6), MoveType::CASTLING);
+    }
+
+    if ((rights & (WHITE_OOO | BLACK_OOO))
+        && !(occupied & (squareBB(squareOf(rank, 1)) | squareBB(squareOf(rank, 2)) | squareBB(squareOf(rank, 3))))
+        && safe(squareOf(rank, 3)) && safe(squareOf(rank, 2))) {
+        moves.emplace_back(kingFrom, squareOf(rank, 2), MoveType::CASTLING);
+    }
+}
+
+// King steps onto squares no enemy piece attacks once the king has left
+template <Color Us>
+void generateKingMoves(const Board& board, const LegalityInfo& info, MoveList& moves, Bitboard targets) {
+    Bitboard occupied = board.pieces() ^ squareBB(info.king);
+
+    for (Bitboard b = Attacks::king(info.king) & targets; b;) {
+        int to = popLsb(b);
+        if (!(board.attackersTo(to, occupied) & board.pieces(~Us))) {
+            moves.emplace_back(info.king, to);
+        }
+    }
+}
+
+template <Color Us>
+void generateAll(const Game& game, MoveList& moves, GenType type) {
+    const Board& board = game.getBoard();
+    LegalityInfo info = computeLegality<Us>(board);
+
+    Bitboard targets = (type == GenType::CAPTURES) ? board.pieces(~Us)
+                     : (type == GenType::QUIETS)   ? ~board.pieces()
+                                                   : ~board.pieces(Us);
+
+    generateKingMoves<Us>(board, info, moves, targets);
+
+    // In double check only the king may move
+    if (popCount(info.checkers) > 1) return;
+
+    if (!info.checkers && type != GenType::CAPTURES) generateCastling<Us>(game, moves);
+
+    generatePawnMoves<Us>(game, info, moves, type);
+
+    targets &= info.checkMask;
+    generatePieceMoves<Us, PieceType::KNIGHT>(board, info, moves, targets);
+    generatePieceMoves<Us, PieceType::BISHOP>(board, info, moves, targets);
+    generatePieceMoves<Us, PieceType::ROOK>(board, info, moves, targets);
+    generatePieceMoves<Us, PieceType::QUEEN>(board, info, moves, targets);
+}
+
+template <Color Us>
+bool isLegalFor(const Game& game, Move move) {
+    const Board& board = game.getBoard();
+    PieceCode piece = board.pieceOn(move.from());
+    if (piece == NO_PIECE || colorOf(piece) != Us || move.from() == move.to()) return false;
+
+    if (move.type() != MoveType::NORMAL) {
+        MoveList moves;
+        generateAll<Us>(game, moves, GenType::ALL);
+        for (const Move& m : moves) {
+            if (m == move) return true;
+        }
+        return false;
+    }
+
+    Bitboard to = squareBB(move.to());
+    PieceType type = typeOf(piece);
+    if (type == PieceType::KING) {
+        return (reach<PieceType::KING, Us>(board, move.from()) & to)
+            && !(board.attackersTo(move.to(), board.pieces() ^ squareBB(move.from())) & board.pieces(~Us));
+    }
+
+    Bitboard targets;
+    switch (type) {
+        case PieceType::PAWN:
+            if (to & (RANK_1 | RANK_8)) return false;
+            targets = reach<PieceType::PAWN, Us>(board, move.from());
+            break;
+        case PieceType::KNIGHT: targets = reach<PieceType::KNIGHT, Us>(board, move.from()); break;
+        case PieceType::BISHOP: targets = reach<PieceType::BISHOP, Us>(board, move.from()); break;
+        case PieceType::ROOK:   targets = reach<PieceType::ROOK, Us>(board, move.from()); break;
+        default:                targets = reach<PieceType::QUEEN, Us>(board, move.from()); break;
+    }
+    if (!(targets & to)) return false;
+
+    LegalityInfo info = computeLegality<Us>(board);
+    return popCount(info.checkers) <= 1 && (to & info.checkMask & pinRestriction(info, move.from()));
+}
+
+template <PieceType Pt, Color Us>
+bool canReachFrom(const Board& board, int from, int to) {
+    return reach<Pt, Us>(board, from) & squareBB(to);
+}
+
+} // namespace
+
+// ============= MOVE GENERATION =============
+
+void generateMoves(const Game& game, MoveList& moves, GenType type) {
+    if (game.getCurrentPlayer() == Color::WHITE) {
+        generateAll<Color::WHITE>(game, moves, type);
+    } else {
+        generateAll<Color::BLACK>(game, moves, type);
+    }
+}
+
+// True if a move from elsewhere (hash table, killer slot) is legal here.
+// Ordinary moves are checked directly; the rare special moves are looked
+// up in the generated list.
+bool isLegal(const Game& game, Move move) {
+    return game.getCurrentPlayer() == Color::WHITE ? isLegalFor<Color::WHITE>(game, move)
+                                                   : isLegalFor<Color::BLACK>(game, move);
+}
+
+// One switch over the piece code selects the instantiation
+bool canReach(const Board& board, PieceCode piece, int from, int to) {
+    switch (piece) {
+        case makePiece(Color::WHITE, PieceType::PAWN):   return canReachFrom<PieceType::PAWN, Color::WHITE>(board, from, to);
+        case makePiece(Color::WHITE, PieceType::ROOK):   return canReachFrom<PieceType::ROOK, Color::WHITE>(board, from, to);
+        case makePiece(Color::WHITE, PieceType::KNIGHT): return canReachFrom<PieceType::KNIGHT, Color::WHITE>(board, from, to);
+        case makePiece(Color::WHITE, PieceType::BISHOP): return canReachFrom<PieceType::BISHOP, Color::WHITE>(board, from, to);
+        case makePiece(Color::WHITE, PieceType::QUEEN):  return canReachFrom<PieceType::QUEEN, Color::WHITE>(board, from, to);
+        case makePiece(Color::WHITE, PieceType::KING):   return canReachFrom<PieceType::KING, Color::WHITE>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::PAWN):   return canReachFrom<PieceType::PAWN, Color::BLACK>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::ROOK):   return canReachFrom<PieceType::ROOK, Color::BLACK>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::KNIGHT): return canReachFrom<PieceType::KNIGHT, Color::BLACK>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::BISHOP): return canReachFrom<PieceType::BISHOP, Color::BLACK>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::QUEEN):  return canReachFrom<PieceType::QUEEN, Color::BLACK>(board, from, to);
+        case makePiece(Color::BLACK, PieceType::KING):   return canReachFrom<PieceType::KING, Color::BLACK>(board, from, to);
+        default:                                         return false;
+    }
+}
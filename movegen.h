@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+
+#include "game.h"
+
+// Which subset of moves to generate. CAPTURES also holds queen promotions,
+// QUIETS holds underpromotions without capture; together they make ALL.
+enum class GenType {
+    ALL, CAPTURES, QUIETS
+};
+
+// Fixed-capacity list of moves stored inline, so generating moves never
+// touches the heap, with a score slot beside each move for ordering. No
+// position has more than 218 legal moves.
+class MoveList {
+public:
+    static const int CAPACITY = 256;
+
+private:
+    Move moves[CAPACITY];
+    int scores[CAPACITY];
+    int count;
+
+public:
+    MoveList() : count(0) {}
+
+    void push_back(Move move) { moves[count++] = move; }
+    void emplace_back(int from, int to, MoveType type = MoveType::NORMAL, PieceType promotion = PieceType::NONE) {
+        moves[count++] = Move(from, to, type, promotion);
+    }
+    void clear() { count = 0; }
+
+    size_t size() const { return static_cast<size_t>(count); }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](size_t i) { return moves[i]; }
+    const Move& operator[](size_t i) const { return moves[i]; }
+    const Move& back() const { return moves[count - 1]; }
+    int& score(size_t i) { return scores[i]; }
+    int score(size_t i) const { return scores[i]; }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Append the side to move's legal moves to the list. Check evasions and
+// pins are resolved with attack masks, so no move needs make/test filtering.
+void generateMoves(const Game& game, MoveList& moves, GenType type = GenType::ALL);
+
+// True if a move from elsewhere (hash table, killer slot) is legal here
+bool isLegal(const Game& game, Move move);
+
+// True if the given piece could move between the two squares on this
+// board by its own movement rules, ignoring checks, pins, castling and en
+// passant (what Piece::isValidMove answers)
+bool canReach(const Board& board, PieceCode piece, int from, int to);
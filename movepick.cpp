@@ -0,0 +1,311 @@
+#include "movepick.h"
+#include "evaluate.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Ordering bands within a stage; quiet moves score their history
+const int CAPTURE_SCORE = 1000000;
+const int PROMOTION_SCORE = 900000;
+const int UNDERPROMOTION_SCORE = -1000000;
+
+int pieceValue(PieceType type) {
+    static const int values[7] = { PAWN_VALUE, ROOK_VALUE, KNIGHT_VALUE, BISHOP_VALUE, QUEEN_VALUE, 2000, 0 };
+    return values[toIndex(type)];
+}
+
+// Gravity update: large bonuses move the entry fast, but it never leaves
+// [-MAX_HISTORY, MAX_HISTORY]
+void addBonus(int& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / MAX_HISTORY;
+}
+
+// Piece that made the last move, or NO_PIECE at the root and after a null move
+PieceCode lastMover(const Game& game) {
+    Move last = game.getLastMove();
+    return (last == Move()) ? NO_PIECE : game.getBoard().pieceOn(last.to());
+}
+
+} // namespace
+
+void OrderingTables::clear() {
+    std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move());
+    std::memset(history, 0, sizeof(history));
+    std::fill(&counterMoves[0][0], &counterMoves[0][0] + 12 * 64, Move());
+}
+
+void OrderingTables::newSearch() {
+    std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move());
+    for (auto& side : history) {
+        for (auto& from : side) {
+            for (int& entry : from) entry /= 2;
+        }
+    }
+}
+
+Move OrderingTables::counterMove(const Game& game) const {
+    PieceCode piece = lastMover(game);
+    return piece != NO_PIECE ? counterMoves[piece][game.getLastMove().to()] : Move();
+}
+
+void OrderingTables::updateQuiet(const Game& game, int ply, Move best, const Move* tried, int triedCount, int depth) {
+    if (!(killers[ply][0] == best)) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = best;
+    }
+
+    int side = toIndex(game.getCurrentPlayer());
+    int bonus = std::min(depth * depth, 400);
+    addBonus(history[side][best.from()][best.to()], bonus);
+    for (int i = 0; i < triedCount; i++) {
+        if (!(tried[i] == best)) addBonus(history[side][tried[i].from()][tried[i].to()], -bonus);
+    }
+
+    PieceCode piece = lastMover(game);
+    if (piece != NO_PIECE) counterMoves[piece][game.getLastMove().to()] = best;
+}
+
+// ============= STATIC EXCHANGE EVALUATION =============
+
+int see(const Game& game, Move move) {
+    if (move.type() == MoveType::CASTLING) return 0;
+
+    const Board& board = game.getBoard();
+    const int to = move.to();
+    int gain[32];
+    int depth = 0;
+
+    PieceType attacker = typeOf(board.pieceOn(move.from()));
+    gain[0] = (move.type() == MoveType::EN_PASSANT) ? PAWN_VALUE
+            : (board.pieceOn(to) != NO_PIECE)     ? pieceValue(typeOf(board.pieceOn(to))) : 0;
+    if (move.type() == MoveType::PROMOTION) {
+        gain[0] += pieceValue(move.promotion()) - PAWN_VALUE;
+        attacker = move.promotion();
+    }
+
+    Bitboard occupied = board.pieces() ^ squareBB(move.from());
+    if (move.type() == MoveType::EN_PASSANT) occupied ^= squareBB(to ^ 8);
+
+    const Bitboard diagonal = board.pieces(PieceType::BISHOP) | board.pieces(PieceType::QUEEN);
+    const Bitboard straight = board.pieces(PieceType::ROOK) | board.pieces(PieceType::QUEEN);
+    Bitboard attackers = board.attackersTo(to, occupied) & occupied;
+    Color side = ~game.getCurrentPlayer();
+
+    static const PieceType CHEAPEST_FIRST[6] = {
+        PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN, PieceType::KING
+    };
+
+    while (depth < 31) {
+        Bitboard ours = attackers & board.pieces(side);
+        if (!ours) break;
+
+        PieceType next = PieceType::KING;
+        Bitboard from = 0;
+        for (PieceType t : CHEAPEST_FIRST) {
+            from = ours & board.pieces(t);
+            if (from) {
+                next = t;
+                break;
+            }
+        }
+
+        // The king may only take last, when nothing can take it back
+        if (next == PieceType::KING && (attackers & board.pieces(~side))) break;
+
+        // Score if the piece on the square is taken. If this side loses
+        // whether it takes or not, leave it out: the sign is already settled.
+        depth++;
+        gain[depth] = pieceValue(attacker) - gain[depth - 1];
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            depth--;
+            break;
+        }
+
+        // Take the attacker off and uncover any slider behind it
+        occupied ^= squareBB(lsb(from));
+        if (next == PieceType::PAWN || next == PieceType::BISHOP || next == PieceType::QUEEN) {
+            attackers |= Attacks::bishop(to, occupied) & diagonal;
+        }
+        if (next == PieceType::ROOK || next == PieceType::QUEEN) {
+            attackers |= Attacks::rook(to, occupied) & straight;
+        }
+        attackers &= occupied;
+        attacker = next;
+        side = ~side;
+    }
+
+    // Negamax the swap list back to the first capture
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
+// ============= MOVE PICKER =============
+
+MovePicker::MovePicker(const Game& g, Move tt, const OrderingTables& t, int p)
+    : game(g), tables(&t), ply(p), capturesOnly(false), stage(Stage::TT_MOVE), ttMove(tt),
+      refutationCount(0), current(0), badCaptureCount(0) {
+    if (ttMove == Move() || !isLegal(game, ttMove)) {
+        ttMove = Move();
+        stage = Stage::GENERATE_CAPTURES;
+    }
+}
+
+MovePicker::MovePicker(const Game& g, Move tt, const OrderingTables& t, int p, bool inCheck)
+    : game(g), tables(&t), ply(p), capturesOnly(!inCheck), stage(Stage::TT_MOVE), ttMove(tt),
+      refutationCount(0), current(0), badCaptureCount(0) {
+    bool usable = inCheck || game.isCapture(ttMove) || ttMove.type() == MoveType::PROMOTION;
+    if (ttMove == Move() || !usable || !isLegal(game, ttMove)) {
+        ttMove = Move();
+        stage = Stage::GENERATE_CAPTURES;
+    }
+}
+
+MovePicker::MovePicker(const Game& g)
+    : game(g), tables(nullptr), ply(0), capturesOnly(false), stage(Stage::GENERATE_CAPTURES),
+      refutationCount(0), current(0), badCaptureCount(0) {}
+
+bool MovePicker::isRefutation(Move move) const {
+    for (int i = 0; i < refutationCount; i++) {
+        if (refutations[i] == move) return true;
+    }
+    return false;
+}
+
+// Most valuable victim first, least valuable attacker as tiebreak
+void MovePicker::scoreCaptures() {
+    const Board& board = game.getBoard();
+    for (size_t i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
+        int score;
+        if (game.isCapture(move)) {
+            PieceType victim = (move.type() == MoveType::EN_PASSANT) ? PieceType::PAWN : typeOf(board.pieceOn(move.to()));
+            score = CAPTURE_SCORE + 10 * pieceValue(victim) - pieceValue(typeOf(board.pieceOn(move.from())));
+        } else {
+            score = PROMOTION_SCORE;
+        }
+        if (move.type() == MoveType::PROMOTION) score += pieceValue(move.promotion());
+        moves.score(i) = score;
+    }
+}
+
+// History order; underpromotions without capture go last
+void MovePicker::scoreQuiets() {
+    int side = toIndex(game.getCurrentPlayer());
+    for (size_t i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
+        if (move.type() == MoveType::PROMOTION) {
+            moves.score(i) = UNDERPROMOTION_SCORE;
+        } else {
+            moves.score(i) = tables ? tables->history[side][move.from()][move.to()] : 0;
+        }
+    }
+}
+
+// Insertion sort on the moves and their scores: lists are short, and at cut nodes
+// only the first few moves are ever looked at
+void MovePicker::sortScored() {
+    for (size_t i = 1; i < moves.size(); i++) {
+        Move move = moves[i];
+        int score = moves.score(i);
+        size_t j = i;
+        for (; j > 0 && moves.score(j - 1) < score; j--) {
+            moves[j] = moves[j - 1];
+            moves.score(j) = moves.score(j - 1);
+        }
+        moves[j] = move;
+        moves.score(j) = score;
+    }
+}
+
+bool MovePicker::next(Move& move) {
+    while (true) {
+        switch (stage) {
+            case Stage::TT_MOVE:
+                stage = Stage::GENERATE_CAPTURES;
+                move = ttMove;
+                return true;
+
+            case Stage::GENERATE_CAPTURES:
+                moves.clear();
+                generateMoves(game, moves, GenType::CAPTURES);
+                scoreCaptures();
+                sortScored();
+                current = 0;
+                stage = Stage::CAPTURES;
+                break;
+
+            case Stage::CAPTURES:
+                while (current < moves.size()) {
+                    move = moves[current++];
+                    if (move == ttMove) continue;
+
+                    // Captures that lose material wait until after the quiets
+                    if (!capturesOnly && tables && see(game, move) < 0) {
+                        badCaptures[badCaptureCount++] = move;
+                        continue;
+                    }
+                    return true;
+                }
+                if (capturesOnly) {
+                    stage = Stage::DONE;
+                    break;
+                }
+                stage = Stage::REFUTATIONS;
+
+                // Killers and the countermove are only worth trying early if
+                // they are legal quiet moves here
+                if (tables) {
+                    Move candidates[3] = { tables->killers[ply][0], tables->killers[ply][1], tables->counterMove(game) };
+                    for (const Move& candidate : candidates) {
+                        if (candidate == Move() || candidate == ttMove || isRefutation(candidate)) continue;
+                        if (game.isCapture(candidate) || candidate.type() == MoveType::PROMOTION) continue;
+                        if (isLegal(game, candidate)) refutations[refutationCount++] = candidate;
+                    }
+                }
+                current = 0;
+                break;
+
+            case Stage::REFUTATIONS:
+                if (current < static_cast<size_t>(refutationCount)) {
+                    move = refutations[current++];
+                    return true;
+                }
+                stage = Stage::GENERATE_QUIETS;
+                break;
+
+            case Stage::GENERATE_QUIETS:
+                moves.clear();
+                generateMoves(game, moves, GenType::QUIETS);
+                scoreQuiets();
+                sortScored();
+                current = 0;
+                stage = Stage::QUIETS;
+                break;
+
+            case Stage::QUIETS:
+                while (current < moves.size()) {
+                    move = moves[current++];
+                    if (!(move == ttMove) && !isRefutation(move)) return true;
+                }
+                stage = Stage::BAD_CAPTURES;
+                current = 0;
+                break;
+
+            case Stage::BAD_CAPTURES:
+                if (current < static_cast<size_t>(badCaptureCount)) {
+                    move = badCaptures[current++];
+                    return true;
+                }
+                stage = Stage::DONE;
+                break;
+
+            case Stage::DONE:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "game.h"
+#include "movegen.h"
+#include "search.h"
+
+// ============= MOVE ORDERING =============
+
+// History scores saturate at +-MAX_HISTORY
+const int MAX_HISTORY = 16384;
+
+// Quiet-move statistics learned during the search; one set per thread
+struct OrderingTables {
+    Move killers[MAX_PLY][2];       // quiet moves that recently cut off at each ply
+    int history[2][64][64];         // butterfly table: side, from, to
+    Move counterMoves[12][64];      // best reply to the previous move's piece and target
+
+    OrderingTables() { clear(); }
+
+    // Forget everything (new game)
+    void clear();
+
+    // Drop the killers and fade the history before the next search
+    void newSearch();
+
+    // Reward a quiet move that caused a beta cutoff and penalize the quiet
+    // moves searched before it
+    void updateQuiet(const Game& game, int ply, Move best, const Move* tried, int triedCount, int depth);
+
+    // Move that refuted the opponent's last move before, if any
+    Move counterMove(const Game& game) const;
+};
+
+// Static exchange evaluation: material won or lost on the target square
+// when both sides keep recapturing with their least valuable attacker,
+// including x-ray attackers behind the first ones. Pins are ignored.
+int see(const Game& game, Move move);
+
+// Yields the legal moves of a position one at a time, best first, and only
+// generates each group of moves when the previous ones are used up:
+//   hash move, winning and even captures by MVV-LVA (with queen
+//   promotions), killers and countermove, quiet moves by history, then the
+//   captures that lose material by SEE
+// A beta cutoff on an early move never pays for generating the quiets.
+class MovePicker {
+private:
+    enum class Stage {
+        TT_MOVE, GENERATE_CAPTURES, CAPTURES, REFUTATIONS, GENERATE_QUIETS, QUIETS, BAD_CAPTURES, DONE
+    };
+
+    const Game& game;
+    const OrderingTables* tables;
+    int ply;
+    bool capturesOnly;
+    Stage stage;
+
+    Move ttMove;
+    Move refutations[3];      // killers, then the countermove
+    int refutationCount;
+
+    MoveList moves;
+    size_t current;
+
+    Move badCaptures[MoveList::CAPACITY];   // losing captures, tried after the quiets
+    int badCaptureCount;
+
+    bool isRefutation(Move move) const;
+    void scoreCaptures();
+    void scoreQuiets();
+    void sortScored();
+
+public:
+    // Ordered by the hash move and the thread's search statistics
+    MovePicker(const Game& game, Move ttMove, const OrderingTables& tables, int ply);
+
+    // Quiescence search: the hash move and captures only, with losing
+    // captures not held back. In check it yields every move in the full
+    // order, losing captures after the quiets.
+    MovePicker(const Game& game, Move ttMove, const OrderingTables& tables, int ply, bool inCheck);
+
+    // Every legal move, captures first, with no search statistics
+    explicit MovePicker(const Game& game);
+
+    // Store the next move and return true, or return false when exhausted
+    bool next(Move& move);
+};
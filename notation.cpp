@@ -0,0 +1,180 @@
+#include "notation.h"
+#include "movegen.h"
+
+// Square name such as "e4"
+std::string squareToString(int sq) {
+    return { static_cast<char>('a' + fileOf(sq)), static_cast<char>('1' + rankOf(sq)) };
+}
+
+// Coordinate (UCI) notation such as "e2e4" or "e7e8q"
+std::string moveToString(Move move) {
+    std::string text = squareToString(move.from()) + squareToString(move.to());
+    if (move.type() == MoveType::PROMOTION) {
+        text += "prnbqk"[toIndex(move.promotion())];
+    }
+    return text;
+}
+
+// The legal move written in coordinate notation, or Move() if there is none
+Move parseMove(const Game& game, const std::string& text) {
+    MoveList moves;
+    generateMoves(game, moves);
+    for (const Move& move : moves) {
+        if (moveToString(move) == text) return move;
+    }
+    return Move();
+}
+
+namespace {
+
+const char PIECE_LETTERS[] = "PRNBQK";
+
+PieceType pieceFromLetter(char c) {
+    for (int t = 1; t < 6; t++) {
+        if (PIECE_LETTERS[t] == c) return static_cast<PieceType>(t);
+    }
+    return PieceType::NONE;
+}
+
+} // namespace
+
+// Standard algebraic notation such as "Nbd7", "exd6", "O-O" or "e8=Q+"
+std::string moveToSAN(const Game& game, Move move) {
+    std::string text;
+    const Board& board = game.getBoard();
+    PieceType type = typeOf(board.pieceOn(move.from()));
+
+    if (move.type() == MoveType::CASTLING) {
+        text = (fileOf(move.to()) == 6) ? "O-O" : "O-O-O";
+    } else {
+        if (type == PieceType::PAWN) {
+            if (game.isCapture(move)) text += static_cast<char>('a' + fileOf(move.from()));
+        } else {
+            text += PIECE_LETTERS[toIndex(type)];
+
+            // Name the origin file, rank or both when another piece of the
+            // same kind could also go there
+            MoveList moves;
+            generateMoves(game, moves);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (const Move& other : moves) {
+                if (other.to() != move.to() || other.from() == move.from()
+                    || typeOf(board.pieceOn(other.from())) != type) {
+                    continue;
+                }
+                ambiguous = true;
+                sameFile |= fileOf(other.from()) == fileOf(move.from());
+                sameRank |= rankOf(other.from()) == rankOf(move.from());
+            }
+            if (ambiguous && (!sameFile || sameRank)) text += static_cast<char>('a' + fileOf(move.from()));
+            if (ambiguous && sameFile) text += static_cast<char>('1' + rankOf(move.from()));
+        }
+        if (game.isCapture(move)) text += 'x';
+        text += squareToString(move.to());
+        if (move.type() == MoveType::PROMOTION) {
+            text += '=';
+            text += PIECE_LETTERS[toIndex(move.promotion())];
+        }
+    }
+
+    Game after = game;
+    after.makeMove(move);
+    if (after.isInCheck(after.getCurrentPlayer())) text += after.hasLegalMoves() ? '+' : '#';
+    return text;
+}
+
+// The legal move written in standard algebraic notation, or Move() if there
+// is none or it is ambiguous
+Move parseSAN(const Game& game, std::string_view text) {
+    while (!text.empty() && std::string_view("+#!?").find(text.back()) != std::string_view::npos) {
+        text.remove_suffix(1);
+    }
+
+    if (text == "O-O" || text == "0-0" || text == "O-O-O" || text == "0-0-0") {
+        int file = (text.size() == 3) ? 6 : 2;
+        MoveList moves;
+        generateMoves(game, moves);
+        for (const Move& move : moves) {
+            if (move.type() == MoveType::CASTLING && fileOf(move.to()) == file) return move;
+        }
+        return Move();
+    }
+
+    // Piece letter, then an optional origin file and rank, an optional
+    // capture mark, the target square and an optional promotion piece
+    PieceType type = PieceType::PAWN;
+    if (!text.empty() && pieceFromLetter(text.front()) != PieceType::NONE) {
+        type = pieceFromLetter(text.front());
+        text.remove_prefix(1);
+    }
+
+    PieceType promotion = PieceType::NONE;
+    if (!text.empty() && pieceFromLetter(text.back()) != PieceType::NONE) {
+        promotion = pieceFromLetter(text.back());
+        if (promotion == PieceType::KING) return Move();   // N, B, R or Q only
+        text.remove_suffix(1);
+        if (!text.empty() && text.back() == '=') text.remove_suffix(1);
+    }
+
+    if (text.size() < 2) return Move();
+    char toFile = text[text.size() - 2], toRank = text[text.size() - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') return Move();
+    int to = squareOf(toRank - '1', toFile - 'a');
+    text.remove_suffix(2);
+    if (!text.empty() && text.back() == 'x') text.remove_suffix(1);
+
+    int fromFile = -1, fromRank = -1;
+    for (char c : text) {
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+        else return Move();
+    }
+
+    // Pieces of the named kind that could have come from the given file and
+    // rank, found by looking back from the target square
+    const Board& board = game.getBoard();
+    Color us = game.getCurrentPlayer();
+    Bitboard occupied = board.pieces();
+    Bitboard candidates;
+    switch (type) {
+        case PieceType::PAWN: {
+            int back = (us == Color::WHITE) ? -8 : 8;
+            if (fromFile >= 0 && fromFile != fileOf(to)) {
+                candidates = Attacks::pawn(~us, to);
+            } else if (to + back >= 0 && to + back < 64) {
+                candidates = squareBB(to + back);
+                if (board.pieceOn(to + back) == NO_PIECE && to + 2 * back >= 0 && to + 2 * back < 64) {
+                    candidates |= squareBB(to + 2 * back);
+                }
+            } else {
+                candidates = 0;
+            }
+            break;
+        }
+        case PieceType::KNIGHT: candidates = Attacks::knight(to); break;
+        case PieceType::BISHOP: candidates = Attacks::bishop(to, occupied); break;
+        case PieceType::ROOK:   candidates = Attacks::rook(to, occupied); break;
+        case PieceType::QUEEN:  candidates = Attacks::queen(to, occupied); break;
+        default:                candidates = Attacks::king(to); break;
+    }
+    candidates &= board.pieces(us, type);
+    if (fromFile >= 0) candidates &= FILE_A << fromFile;
+    if (fromRank >= 0) candidates &= RANK_1 << (8 * fromRank);
+
+    bool lastRank = type == PieceType::PAWN && (squareBB(to) & (RANK_1 | RANK_8));
+    if (lastRank != (promotion != PieceType::NONE)) return Move();
+
+    Move found;
+    int matches = 0;
+    while (candidates) {
+        int from = popLsb(candidates);
+        Move move = lastRank ? Move(from, to, MoveType::PROMOTION, promotion)
+                  : (type == PieceType::PAWN && to == game.getEpSquare()) ? Move(from, to, MoveType::EN_PASSANT)
+                  : Move(from, to);
+        if (isLegal(game, move)) {
+            found = move;
+            matches++;
+        }
+    }
+    return matches == 1 ? found : Move();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "game.h"
+
+// Square name such as "e4"
+std::string squareToString(int sq);
+
+// Coordinate (UCI) notation such as "e2e4" or "e7e8q"
+std::string moveToString(Move move);
+
+// The legal move written in coordinate notation, or Move() if there is none
+Move parseMove(const Game& game, const std::string& text);
+
+// Standard algebraic notation such as "Nbd7", "exd6", "O-O" or "e8=Q+"
+std::string moveToSAN(const Game& game, Move move);
+
+// The legal move written in standard algebraic notation, or Move() if there
+// is none or it is ambiguous. Check, capture and annotation marks are
+// optional. Does not allocate.
+Move parseSAN(const Game& game, std::string_view text);
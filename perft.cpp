@@ -0,0 +1,146 @@
+// Perft: count leaf nodes of the legal move tree to check move generation
+// for correctness and speed, without SFML.
+//
+//   perft <depth>              divide from the start position
+//   perft "<fen>" <depth>      divide from any position
+//   perft --suite [maxDepth]   run the reference positions
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "game.h"
+#include "movegen.h"
+#include "notation.h"
+
+namespace {
+
+struct ReferencePosition {
+    const char* name;
+    const char* fen;
+    int quickDepth;           // depth run by --suite without a limit
+    uint64_t expected[7];     // expected[d - 1] = nodes at depth d, 0 = unknown
+};
+
+// Standard perft positions (chessprogramming.org/Perft_Results)
+const ReferencePosition REFERENCE[] = {
+    { "startpos", START_FEN, 5,
+      { 20, 400, 8902, 197281, 4865609, 119060324, 3195901860ULL } },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+      { 48, 2039, 97862, 4085603, 193690690, 8031647685ULL, 0 } },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5,
+      { 14, 191, 2812, 43238, 674624, 11030083, 178633661 } },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4,
+      { 6, 264, 9467, 422333, 15833292, 706045033, 0 } },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+      { 44, 1486, 62379, 2103487, 89941194, 0, 0 } },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4,
+      { 46, 2079, 89890, 3894594, 164075551, 6923051137ULL, 0 } },
+};
+
+uint64_t perft(Game& game, int depth) {
+    MoveList moves;
+    generateMoves(game, moves);
+
+    // Moves are strictly legal, so the last ply is just a count
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        game.makeMove(move);
+        nodes += perft(game, depth - 1);
+        game.undoMove();
+    }
+    return nodes;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printSpeed(uint64_t nodes, double seconds) {
+    std::cout << nodes << " nodes in " << seconds << " s ("
+              << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << " nodes/s)\n";
+}
+
+// Per-root-move counts followed by the total
+int divide(const std::string& fen, int depth) {
+    if (depth < 1) {
+        std::cerr << "Depth must be at least 1\n";
+        return 1;
+    }
+
+    Game game;
+    if (!game.loadFEN(fen)) {
+        std::cerr << "Invalid FEN: " << fen << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MoveList moves;
+    generateMoves(game, moves);
+
+    uint64_t total = 0;
+    for (const Move& move : moves) {
+        game.makeMove(move);
+        uint64_t nodes = (depth > 1) ? perft(game, depth - 1) : 1;
+        game.undoMove();
+
+        std::cout << moveToString(move) << ": " << nodes << "\n";
+        total += nodes;
+    }
+
+    std::cout << "\nTotal: ";
+    printSpeed(total, secondsSince(start));
+    return 0;
+}
+
+int runSuite(int maxDepth) {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    auto suiteStart = std::chrono::steady_clock::now();
+
+    for (const ReferencePosition& ref : REFERENCE) {
+        Game game;
+        game.loadFEN(ref.fen);
+
+        int depth = (maxDepth > 0) ? maxDepth : ref.quickDepth;
+        for (int d = 1; d <= depth && d <= 7 && ref.expected[d - 1]; d++) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = perft(game, d);
+            bool ok = nodes == ref.expected[d - 1];
+            failures += !ok;
+            totalNodes += nodes;
+
+            std::cout << (ok ? "ok   " : "FAIL ") << ref.name << " depth " << d << ": ";
+            if (!ok) std::cout << "expected " << ref.expected[d - 1] << ", got ";
+            printSpeed(nodes, secondsSince(start));
+        }
+    }
+
+    std::cout << "\nSuite: " << failures << " failures, ";
+    printSpeed(totalNodes, secondsSince(suiteStart));
+    return failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string first = (argc > 1) ? argv[1] : "";
+
+    if (first == "--suite") {
+        return runSuite(argc > 2 ? std::atoi(argv[2]) : 0);
+    }
+    if (argc == 2) {
+        return divide(START_FEN, std::atoi(argv[1]));
+    }
+    if (argc == 3) {
+        return divide(first == "startpos" ? START_FEN : first, std::atoi(argv[2]));
+    }
+
+    std::cerr << "usage: perft <depth>\n"
+              << "       perft <fen|startpos> <depth>\n"
+              << "       perft --suite [maxDepth]\n";
+    return 1;
+}
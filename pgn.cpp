@@ -0,0 +1,211 @@
+#include "pgn.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "notation.h"
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isResult(std::string_view token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// Walks the text once; every token is a view into it
+class PgnReader {
+private:
+    std::string_view text;
+    size_t pos;
+    PgnVisitor& visitor;
+    PgnStats stats;
+
+    const Game startPosition;
+    Game game;
+    std::string_view fen;   // FEN tag of the game about to start
+    bool inGame;            // movetext has begun
+    bool wanted;            // the visitor takes this game's moves
+    bool failed;
+    int plies;
+
+    void skipPast(char end) {
+        size_t found = text.find(end, pos);
+        pos = (found == std::string_view::npos) ? text.size() : found + 1;
+    }
+
+    // Recursive annotation variation, which may nest and hold comments
+    void skipVariation() {
+        int depth = 0;
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '(') depth++;
+            else if (c == ')' && --depth == 0) return;
+            else if (c == '{') skipPast('}');
+            else if (c == ';') skipPast('\n');
+        }
+    }
+
+    // [Name "value"], with \" and \\ escapes left in place
+    void readTag() {
+        size_t close = text.find(']', pos);
+        size_t open = text.find('"', pos);
+        if (open == std::string_view::npos || open > close) {
+            pos = (close == std::string_view::npos) ? text.size() : close + 1;
+            return;
+        }
+
+        size_t nameStart = pos + 1;
+        while (nameStart < open && isSpace(text[nameStart])) nameStart++;
+        size_t nameEnd = nameStart;
+        while (nameEnd < open && !isSpace(text[nameEnd])) nameEnd++;
+
+        size_t valueEnd = open + 1;
+        while (valueEnd < text.size() && text[valueEnd] != '"') valueEnd += (text[valueEnd] == '\\') ? 2 : 1;
+        valueEnd = std::min(valueEnd, text.size());
+
+        std::string_view name = text.substr(nameStart, nameEnd - nameStart);
+        std::string_view value = text.substr(open + 1, valueEnd - open - 1);
+        if (name == "FEN") fen = value;
+        visitor.tag(name, value);
+
+        pos = valueEnd;
+        skipPast(']');
+    }
+
+    void beginGame() {
+        inGame = true;
+        failed = false;
+        plies = 0;
+        if (fen.empty()) {
+            game = startPosition;
+        } else {
+            failed = !game.loadFEN(std::string(fen));
+        }
+        wanted = !failed && visitor.startGame(game);
+    }
+
+    void endGame(std::string_view result) {
+        stats.games++;
+        stats.errors += failed;
+        if (wanted) visitor.endGame(game, result, !failed);
+        inGame = false;
+        fen = std::string_view();
+    }
+
+    void playMove(std::string_view san) {
+        if (!wanted || failed) return;
+        Move move = (plies < MAX_GAME_PLIES) ? parseSAN(game, san) : Move();
+        if (move == Move()) {
+            failed = true;
+            return;
+        }
+        visitor.move(game, move);
+        game.makeMove(move);
+        plies++;
+        stats.moves++;
+    }
+
+    // A movetext token: a move number, a result or a move
+    void readToken() {
+        size_t start = pos;
+        while (pos < text.size() && !isSpace(text[pos]) && std::string_view("{}()[];$").find(text[pos]) == std::string_view::npos) {
+            pos++;
+        }
+        std::string_view token = text.substr(start, pos - start);
+        if (token.empty()) {
+            pos++;
+            return;
+        }
+
+        if (!inGame) beginGame();
+        if (isResult(token)) {
+            endGame(token);
+            return;
+        }
+
+        // "12." or "12..." may be written against the move itself
+        size_t skip = 0;
+        while (skip < token.size() && token[skip] >= '0' && token[skip] <= '9') skip++;
+        while (skip < token.size() && token[skip] == '.') skip++;
+        token.remove_prefix(skip);
+        if (!token.empty()) playMove(token);
+    }
+
+public:
+    PgnReader(std::string_view pgn, PgnVisitor& v)
+        : text(pgn), pos(0), visitor(v), inGame(false), wanted(false), failed(false), plies(0) {}
+
+    PgnStats read() {
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (isSpace(c)) {
+                pos++;
+            } else if (c == '%' && (pos == 0 || text[pos - 1] == '\n')) {
+                skipPast('\n');
+            } else if (c == '[') {
+                // A game without a result ends where the next one's tags begin
+                if (inGame) endGame("*");
+                readTag();
+            } else if (c == '{') {
+                skipPast('}');
+            } else if (c == ';') {
+                skipPast('\n');
+            } else if (c == '(') {
+                skipVariation();
+            } else if (c == '$') {
+                pos++;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+            } else {
+                readToken();
+            }
+        }
+        if (inGame) endGame("*");
+        return stats;
+    }
+};
+
+} // namespace
+
+PgnStats readPgn(std::string_view text, PgnVisitor& visitor) {
+    return PgnReader(text, visitor).read();
+}
+
+// Games are cut where a line opens with the Event tag, which the PGN
+// standard puts first in every game
+std::vector<std::string_view> splitPgn(std::string_view text, int pieces) {
+    std::vector<std::string_view> result;
+    size_t start = 0;
+    for (int i = 1; i <= pieces && start < text.size(); i++) {
+        size_t end = text.size();
+        if (i < pieces) {
+            size_t target = std::max(start, text.size() / pieces * i);
+            size_t found = text.find("\n[Event ", target);
+            if (found != std::string_view::npos) end = found + 1;
+        }
+        result.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return result;
+}
+
+PgnStats readPgnParallel(std::string_view text, const std::vector<PgnVisitor*>& visitors) {
+    std::vector<std::string_view> pieces = splitPgn(text, static_cast<int>(visitors.size()));
+    std::vector<PgnStats> results(pieces.size());
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        threads.emplace_back([&, i] { results[i] = readPgn(pieces[i], *visitors[i]); });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    PgnStats total;
+    for (const PgnStats& stats : results) {
+        total.games += stats.games;
+        total.moves += stats.moves;
+        total.errors += stats.errors;
+    }
+    return total;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game.h"
+#include "mappedfile.h"
+
+// Receives the games of a PGN text as they are replayed. Every string_view
+// points into the text itself and is valid only during the call.
+class PgnVisitor {
+public:
+    virtual ~PgnVisitor() = default;
+
+    // A tag pair of the game about to be read, such as Event or White
+    virtual void tag(std::string_view /*name*/, std::string_view /*value*/) {}
+
+    // The starting position (from a FEN tag, else the standard one);
+    // return false to skip the moves of this game
+    virtual bool startGame(const Game& /*game*/) { return true; }
+
+    // A move about to be made in the given position
+    virtual void move(const Game& /*game*/, Move /*move*/) {}
+
+    // End of the game: its result ("1-0", "0-1", "1/2-1/2" or "*"), and
+    // whether every move was read
+    virtual void endGame(const Game& /*game*/, std::string_view /*result*/, bool /*complete*/) {}
+};
+
+// Totals over the games of one read
+struct PgnStats {
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    uint64_t errors = 0;    // games cut short by a bad or illegal move or a bad FEN
+};
+
+// Replay every game in a PGN text through the visitor. Comments,
+// variations, NAGs and escape lines are skipped. Moves are parsed in place
+// with no allocation per move.
+PgnStats readPgn(std::string_view text, PgnVisitor& visitor);
+
+// Split a PGN text into at most the given number of pieces of similar
+// size, each starting at a game's first tag
+std::vector<std::string_view> splitPgn(std::string_view text, int pieces);
+
+// Read the pieces of a PGN text on one thread per visitor
+PgnStats readPgnParallel(std::string_view text, const std::vector<PgnVisitor*>& visitors);
@@ -0,0 +1,48 @@
+#include "piece.h"
+#include "board.h"
+#include "movegen.h"
+
+Pawn::Pawn(Color c, Position pos) : Piece(c, PieceType::PAWN, pos) {}
+Rook::Rook(Color c, Position pos) : Piece(c, PieceType::ROOK, pos) {}
+Knight::Knight(Color c, Position pos) : Piece(c, PieceType::KNIGHT, pos) {}
+Bishop::Bishop(Color c, Position pos) : Piece(c, PieceType::BISHOP, pos) {}
+Queen::Queen(Color c, Position pos) : Piece(c, PieceType::QUEEN, pos) {}
+King::King(Color c, Position pos) : Piece(c, PieceType::KING, pos) {}
+
+// ============= PIECE CLASS IMPLEMENTATIONS =============
+
+// Piece constructor
+Piece::Piece(Color c, PieceType t, Position pos)
+    : color(c), type(t), position(pos), hasMoved(false) {}
+
+// Piece getters
+Color Piece::getColor() const { return color; }
+PieceType Piece::getType() const { return type; }
+Position Piece::getPosition() const { return position; }
+bool Piece::hasMovedBefore() const { return hasMoved; }
+
+// Piece setters
+void Piece::setPosition(Position pos) { position = pos; }
+void Piece::setHasMoved(bool moved) { hasMoved = moved; }
+
+char Piece::getSymbol() const {
+    return "PRNBQKprnbqk"[makePiece(color, type)];
+}
+
+// Shared piece object for a mailbox piece code
+const Piece& Piece::forCode(PieceCode piece) {
+    static const Piece table[12] = {
+        Pawn(Color::WHITE, Position()), Rook(Color::WHITE, Position()), Knight(Color::WHITE, Position()),
+        Bishop(Color::WHITE, Position()), Queen(Color::WHITE, Position()), King(Color::WHITE, Position()),
+        Pawn(Color::BLACK, Position()), Rook(Color::BLACK, Position()), Knight(Color::BLACK, Position()),
+        Bishop(Color::BLACK, Position()), Queen(Color::BLACK, Position()), King(Color::BLACK, Position()),
+    };
+    return table[piece];
+}
+
+// ============= PIECE MOVE VALIDATION =============
+
+bool Piece::isValidMove(Position from, Position to, Board& board) const {
+    if (!from.isValid() || !to.isValid()) return false;
+    return canReach(board, makePiece(color, type), toSquare(from), toSquare(to));
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "types.h"
+
+class Board;
+
+// Compatibility shim over the templated move rules in movegen. A Piece
+// only remembers its color, type, square and whether it has moved; move
+// checks go straight to canReach, with no virtual dispatch.
+class Piece {
+protected:
+    Color color;
+    PieceType type;
+    Position position;
+    bool hasMoved;
+
+public:
+    Piece(Color c, PieceType t, Position pos);
+    virtual ~Piece() = default;
+
+    // Getters
+    Color getColor() const;
+    PieceType getType() const;
+    Position getPosition() const;
+    bool hasMovedBefore() const;
+
+    // Setters
+    void setPosition(Position pos);
+    void setHasMoved(bool moved);
+
+    // True if this piece may move from one square to another by its own
+    // movement rules (checks, castling and en passant are not considered)
+    bool isValidMove(Position from, Position to, Board& board) const;
+
+    // Piece letter, uppercase for White
+    char getSymbol() const;
+
+    // Shared piece object for a mailbox piece code
+    static const Piece& forCode(PieceCode piece);
+};
+
+// The piece kinds, kept so existing code can still name them
+class Pawn : public Piece {
+public:
+    Pawn(Color c, Position pos);
+};
+
+class Rook : public Piece {
+public:
+    Rook(Color c, Position pos);
+};
+
+class Knight : public Piece {
+public:
+    Knight(Color c, Position pos);
+};
+
+class Bishop : public Piece {
+public:
+    Bishop(Color c, Position pos);
+};
+
+class Queen : public Piece {
+public:
+    Queen(Color c, Position pos);
+};
+
+class King : public Piece {
+public:
+    King(Color c, Position pos);
+};
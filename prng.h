@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// xorshift64* pseudo-random generator; deterministic for a given seed
+class PRNG {
+private:
+    uint64_t state;
+
+public:
+    explicit PRNG(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Value with roughly 1/8 of its bits set (good magic candidates)
+    uint64_t sparse() { return next() & next() & next(); }
+};
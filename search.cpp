@@ -0,0 +1,598 @@
+#include "search.h"
+#include "bitbase.h"
+#include "evaluate.h"
+#include "movegen.h"
+#include "movepick.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int ASPIRATION_WINDOW = 25;
+
+// Clock time kept back for GUI and OS latency
+const int MOVE_OVERHEAD_MS = 30;
+
+// Lazy SMP depth staggering: helper i skips iterations in blocks of
+// SKIP_SIZE starting at SKIP_PHASE, so neighbouring helpers diverge
+const int SKIP_SIZE[20]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+const int SKIP_PHASE[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// Margins for pruning on the static evaluation near the leaves
+const int REVERSE_FUTILITY_DEPTH = 6;
+const int REVERSE_FUTILITY_MARGIN = 80;     // per ply of depth
+const int FUTILITY_DEPTH = 3;
+const int FUTILITY_MARGIN = 100;            // plus this per ply of depth
+
+const int NULL_MOVE_DEPTH = 3;
+
+// Late move reductions grow with the log of both the depth and the number
+// of moves already searched
+struct ReductionTable {
+    int plies[64][64];
+
+    ReductionTable() {
+        for (int depth = 0; depth < 64; depth++) {
+            for (int moves = 0; moves < 64; moves++) {
+                plies[depth][moves] = (depth && moves)
+                    ? static_cast<int>(0.75 + std::log(depth) * std::log(moves) / 2.25) : 0;
+            }
+        }
+    }
+
+    int operator()(int depth, int moveCount) const {
+        return plies[std::min(depth, 63)][std::min(moveCount, 63)];
+    }
+};
+
+const ReductionTable REDUCTIONS;
+
+// Mate scores are stored relative to the node so they stay valid when the
+// same position is reached at another distance from the root
+int scoreToTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
+
+int scoreFromTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
+
+} // namespace
+
+bool SearchFeatures::set(const std::string& name, bool enabled) {
+    if (name == "nullmove") nullMove = enabled;
+    else if (name == "lmr") lateMoveReductions = enabled;
+    else if (name == "rfp") reverseFutility = enabled;
+    else if (name == "futility") futility = enabled;
+    else if (name == "checkext") checkExtensions = enabled;
+    else return false;
+    return true;
+}
+
+// ============= SEARCH WORKER =============
+
+// Per-thread search state: its own copy of the game and PV table
+struct Search::Worker {
+    Search& search;
+    int index;
+    Game game;
+    std::atomic<uint64_t> nodes;   // written by this worker only
+    int rootDepth = 0;
+    bool stopped = false;
+    SearchResult completed;        // last fully searched iteration
+    OrderingTables ordering;
+
+    // Beta cutoffs, and how many of them came from the first move searched
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+
+    // Transposition table probes and hits, kept per thread so the shared
+    // table is never written just to count; summed when the search ends
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+
+    Move pv[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength[MAX_PLY + 1];
+
+    Worker(Search& s, int i) : search(s), index(i), nodes(0) {}
+
+    void iterate();
+    int negamax(int depth, int ply, int alpha, int beta);
+    int quiescence(int ply, int alpha, int beta);
+
+    // Count a node and poll the stop conditions; true if the search must end
+    bool visitNode() {
+        nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (search.shouldStop(*this)) stopped = true;
+        return stopped;
+    }
+};
+
+// Resolve captures at the leaves so the static evaluation is only trusted
+// in quiet positions. Captures that lose material by SEE are skipped; when
+// in check every evasion is searched, so mates are still found.
+int Search::Worker::quiescence(int ply, int alpha, int beta) {
+    pvLength[ply] = ply;
+    bool pvNode = beta - alpha > 1;
+
+    if (visitNode()) return 0;
+    if (ply >= MAX_PLY) return evaluate(game);
+
+    uint64_t key = game.getKey();
+    TTData entry;
+    Move ttMove;
+    ttProbes++;
+    if (search.tt.probe(key, entry)) {
+        ttHits++;
+        ttMove = entry.move;
+        int ttScore = scoreFromTT(entry.score, ply);
+        if (!pvNode
+            && (entry.bound == Bound::EXACT
+                || (entry.bound == Bound::LOWER && ttScore >= beta)
+                || (entry.bound == Bound::UPPER && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+
+    // Stand pat: the side to move can usually decline to capture
+    bool inCheck = game.isInCheck(game.getCurrentPlayer());
+    int bestScore = -INFINITE_SCORE;
+    if (!inCheck) {
+        bestScore = evaluate(game);
+        if (bestScore >= beta) return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+
+    int originalAlpha = alpha;
+    Move bestMove;
+    int moveCount = 0;
+
+    MovePicker picker(game, ttMove, ordering, ply, inCheck);
+    Move move;
+    while (picker.next(move)) {
+        moveCount++;
+        if (!inCheck && see(game, move) < 0) continue;
+
+        game.makeMove(move);
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        game.undoMove();
+        if (stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+
+            if (score > alpha) {
+                alpha = score;
+                pv[ply][ply] = move;
+                for (int i = ply + 1; i < pvLength[ply + 1]; i++) pv[ply][i] = pv[ply + 1][i];
+                pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    if (inCheck && moveCount == 0) return -MATE_SCORE + ply;
+
+    Bound bound = (bestScore >= beta) ? Bound::LOWER
+                : (bestScore > originalAlpha) ? Bound::EXACT : Bound::UPPER;
+    search.tt.store(key, bestMove, scoreToTT(bestScore, ply), 0, 0, bound);
+    return bestScore;
+}
+
+int Search::Worker::negamax(int depth, int ply, int alpha, int beta) {
+    if (depth <= 0) return quiescence(ply, alpha, beta);
+
+    pvLength[ply] = ply;
+    bool pvNode = beta - alpha > 1;
+
+    if (visitNode()) return 0;
+    if (ply >= MAX_PLY) return evaluate(game);
+
+    if (ply > 0) {
+        if (game.getHalfmoveClock() >= 100 || game.isRepetition()) return 0;
+
+        // Mate distance pruning: no line from here beats a shorter mate
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if (alpha >= beta) return alpha;
+
+        // Covered endings are scored exactly, with no search below them
+        int tableScore;
+        if (search.bitbases && search.bitbases->probeScore(game, ply, tableScore)) return tableScore;
+    }
+
+    uint64_t key = game.getKey();
+    TTData entry;
+    Move ttMove;
+    ttProbes++;
+    if (search.tt.probe(key, entry)) {
+        ttHits++;
+        ttMove = entry.move;
+        int ttScore = scoreFromTT(entry.score, ply);
+        if (!pvNode && entry.depth >= depth
+            && (entry.bound == Bound::EXACT
+                || (entry.bound == Bound::LOWER && ttScore >= beta)
+                || (entry.bound == Bound::UPPER && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+
+    const SearchFeatures& features = search.features;
+    Color us = game.getCurrentPlayer();
+    bool inCheck = game.isInCheck(us);
+    int staticEval = inCheck ? -INFINITE_SCORE : evaluate(game);
+
+    if (!pvNode && !inCheck && ply > 0) {
+        // Reverse futility: this far above beta, a few plies of quiet moves
+        // by the opponent are unlikely to bring the score back down
+        if (features.reverseFutility && depth <= REVERSE_FUTILITY_DEPTH && std::abs(beta) < MATE_BOUND
+            && staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+            return staticEval;
+        }
+
+        // Null move: if passing still fails high, a real move almost surely
+        // would too. Not twice in a row, and not with only king and pawns,
+        // where passing is often the best move (zugzwang).
+        Bitboard pieces = game.getBoard().pieces(us)
+                        ^ game.getBoard().pieces(us, PieceType::PAWN) ^ game.getBoard().pieces(us, PieceType::KING);
+        if (features.nullMove && depth >= NULL_MOVE_DEPTH && staticEval >= beta && pieces
+            && !(game.getLastMove() == Move())) {
+            int reduction = 3 + depth / 6;
+            game.makeNullMove();
+            int score = -negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+            game.undoNullMove();
+            if (stopped) return 0;
+
+            // Mates found after passing are not proven
+            if (score >= beta) return (score >= MATE_BOUND) ? beta : score;
+        }
+    }
+
+    MovePicker picker(game, ttMove, ordering, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove;
+    Move quietsTried[64];
+    int quietCount = 0;
+    int moveCount = 0;
+
+    Move move;
+    while (picker.next(move)) {
+        bool first = (moveCount++ == 0);
+        bool quiet = !game.isCapture(move) && move.type() != MoveType::PROMOTION;
+        game.makeMove(move);
+        bool givesCheck = game.isInCheck(game.getCurrentPlayer());
+        int newDepth = depth - 1 + (givesCheck && features.checkExtensions);
+
+        // Futility: near the leaves, a quiet move cannot lift a static
+        // evaluation this far below alpha
+        if (features.futility && !first && !pvNode && !inCheck && !givesCheck && quiet
+            && depth <= FUTILITY_DEPTH && bestScore > -MATE_BOUND
+            && staticEval + FUTILITY_MARGIN * (depth + 1) <= alpha) {
+            game.undoMove();
+            continue;
+        }
+
+        // Principal variation search: full window for the first move only,
+        // null windows for the rest with a re-search if one beats alpha.
+        // Late quiet moves are searched shallower first.
+        int score;
+        if (first) {
+            score = -negamax(newDepth, ply + 1, -beta, -alpha);
+        } else {
+            int reduction = 0;
+            if (features.lateMoveReductions && depth >= 3 && quiet && !inCheck && !givesCheck
+                && moveCount > (pvNode ? 3 : 1)) {
+                reduction = REDUCTIONS(depth, moveCount) - pvNode;
+                reduction = std::max(0, std::min(reduction, newDepth - 1));
+            }
+
+            score = -negamax(newDepth - reduction, ply + 1, -alpha - 1, -alpha);
+            if (reduction && score > alpha) {
+                score = -negamax(newDepth, ply + 1, -alpha - 1, -alpha);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(newDepth, ply + 1, -beta, -alpha);
+            }
+        }
+
+        game.undoMove();
+        if (stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+
+            if (score > alpha) {
+                alpha = score;
+                pv[ply][ply] = move;
+                for (int i = ply + 1; i < pvLength[ply + 1]; i++) pv[ply][i] = pv[ply + 1][i];
+                pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+
+                if (alpha >= beta) {
+                    cutoffs++;
+                    firstMoveCutoffs += first;
+                    if (quiet) ordering.updateQuiet(game, ply, move, quietsTried, quietCount, depth);
+                    break;
+                }
+            }
+        }
+        if (quiet && quietCount < 64) quietsTried[quietCount++] = move;
+    }
+
+    if (moveCount == 0) return inCheck ? -MATE_SCORE + ply : 0;
+
+    Bound bound = (bestScore >= beta) ? Bound::LOWER
+                : (bestScore > originalAlpha) ? Bound::EXACT : Bound::UPPER;
+    search.tt.store(key, bestMove, scoreToTT(bestScore, ply), 0, depth, bound);
+    return bestScore;
+}
+
+// Iterative deepening from depth 1 up to the depth limit. Helpers skip
+// some depths so the threads spread over different iterations.
+void Search::Worker::iterate() {
+    int maxDepth = (search.limits.depth > 0) ? std::min(search.limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    int previousScore = 0;
+
+    for (rootDepth = 1; rootDepth <= maxDepth; rootDepth++) {
+        if (index > 0) {
+            int i = (index - 1) % 20;
+            if (((rootDepth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2) continue;
+        }
+
+        // Aspiration window around the previous score, widened on failure
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -INFINITE_SCORE, beta = INFINITE_SCORE;
+        if (rootDepth >= 4) {
+            alpha = std::max(previousScore - delta, -INFINITE_SCORE);
+            beta = std::min(previousScore + delta, INFINITE_SCORE);
+        }
+
+        int score;
+        while (true) {
+            score = negamax(rootDepth, 0, alpha, beta);
+            if (stopped) break;
+
+            if (score <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -INFINITE_SCORE);
+            } else if (score >= beta) {
+                beta = std::min(score + delta, INFINITE_SCORE);
+            } else {
+                break;
+            }
+            delta += delta / 2;
+        }
+
+        // Results of an interrupted iteration are not trusted
+        if (stopped) break;
+
+        previousScore = score;
+        completed.score = score;
+        completed.depth = rootDepth;
+        completed.pv.clear();
+        for (int i = 0; i < pvLength[0]; i++) completed.pv.push_back(pv[0][i]);
+        completed.bestMove = completed.pv.empty() ? search.rootMoves[0] : completed.pv[0];
+
+        if (index == 0 && search.onIteration) {
+            SearchResult progress = completed;
+            progress.nodes = search.totalNodes();
+            progress.timeMs = search.elapsedMs();
+            search.onIteration(progress);
+        }
+
+        // Only one legal move, a mate found within this depth, or too
+        // little time left to finish another iteration. Infinite and
+        // pondering searches only end on request.
+        if (index == 0 && !search.limits.infinite && !search.pondering.load(std::memory_order_relaxed)) {
+            if (search.rootMoves.size() == 1 && search.limits.depth == 0) break;
+            if (std::abs(score) >= MATE_BOUND && MATE_SCORE - std::abs(score) <= rootDepth) break;
+            if (search.optimumTime && search.elapsedMs() >= search.optimumTime) break;
+        }
+    }
+}
+
+// ============= SEARCH =============
+
+Search::Search(TranspositionTable& table, int threads)
+    : tt(table), stopFlag(false), bitbases(nullptr), pondering(false), armed(false), optimumTime(0), maximumTime(0), searchId(0), runningHelpers(0), quitting(false) {
+    setThreads(threads);
+}
+
+Search::~Search() {
+    stopHelpers();
+}
+
+void Search::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+    }
+    wakeHelpers.notify_all();
+    for (std::thread& thread : helpers) thread.join();
+    helpers.clear();
+    quitting = false;
+}
+
+// Number of search threads including the caller's; at least one
+void Search::setThreads(int threads) {
+    stopHelpers();
+    workers.clear();
+
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(new Worker(*this, i));
+    }
+    for (int i = 1; i < threads; i++) {
+        helpers.emplace_back(&Search::helperLoop, this, std::ref(*workers[i]), searchId);
+    }
+}
+
+// Helper threads sleep here between searches. The id of the last search
+// is passed in, since a new thread may only get here after think() has
+// already started the next one.
+void Search::helperLoop(Worker& worker, uint64_t lastSearch) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        wakeHelpers.wait(lock, [&] { return quitting || searchId != lastSearch; });
+        if (quitting) return;
+        lastSearch = searchId;
+
+        lock.unlock();
+        worker.iterate();
+        lock.lock();
+
+        if (--runningHelpers == 0) helpersDone.notify_all();
+    }
+}
+
+void Search::arm(bool ponder) {
+    stopFlag.store(false, std::memory_order_relaxed);
+    pondering.store(ponder, std::memory_order_relaxed);
+    armed = true;
+}
+
+void Search::stop() {
+    stopFlag.store(true, std::memory_order_relaxed);
+}
+
+void Search::ponderhit() {
+    pondering.store(false, std::memory_order_relaxed);
+}
+
+int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint64_t Search::totalNodes() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) total += worker->nodes.load(std::memory_order_relaxed);
+    return total;
+}
+
+// Helpers only watch the stop flag. The main thread polls the limits every
+// 1024 nodes and never stops before depth 1 is done.
+bool Search::shouldStop(const Worker& worker) {
+    if (stopFlag.load(std::memory_order_relaxed)) return true;
+    if (worker.index != 0) return false;
+
+    // Limits never cut the first iteration short, so a move is found
+    if (worker.rootDepth <= 1) return false;
+
+    uint64_t nodes = worker.nodes.load(std::memory_order_relaxed);
+    if (limits.nodes && workers.size() == 1 && nodes >= limits.nodes) return true;
+    if ((nodes & 1023) != 0) return false;
+    if (limits.nodes && totalNodes() >= limits.nodes) return true;
+    return maximumTime && !pondering.load(std::memory_order_relaxed) && elapsedMs() >= maximumTime;
+}
+
+// Turn the limits into a time budget. A fixed movetime is used as is;
+// otherwise spend a share of the clock plus most of the increment, and
+// allow overrunning that in a difficult iteration up to a hard cap. With a
+// clock given but our own at or below zero, move as soon as depth 1 is done.
+void Search::allocateTime(Color us) {
+    optimumTime = maximumTime = 0;
+    if (limits.movetime) {
+        optimumTime = maximumTime = limits.movetime;
+        return;
+    }
+
+    bool clocked = limits.time[0] || limits.time[1] || limits.increment[0] || limits.increment[1] || limits.movesToGo;
+    int64_t remaining = limits.time[toIndex(us)];
+    if (!clocked) return;
+    if (remaining <= 0) {
+        optimumTime = maximumTime = 1;
+        return;
+    }
+
+    int64_t increment = limits.increment[toIndex(us)];
+    int64_t movesLeft = limits.movesToGo ? std::min(limits.movesToGo, 40) : 30;
+    int64_t available = std::max<int64_t>(remaining - MOVE_OVERHEAD_MS, 1);
+
+    int64_t cap = std::max<int64_t>(available * 4 / 5, 1);
+    optimumTime = std::max<int64_t>(std::min(remaining / movesLeft + increment * 3 / 4, cap), 1);
+    maximumTime = std::min(optimumTime * 5, cap);
+}
+
+SearchResult Search::think(const Game& game, const SearchLimits& searchLimits) {
+    limits = searchLimits;
+    startTime = std::chrono::steady_clock::now();
+    if (!armed) arm(limits.ponder);
+    armed = false;
+    allocateTime(game.getCurrentPlayer());
+    tt.newSearch();
+
+    SearchResult result;
+    rootMoves.clear();
+    generateMoves(game, rootMoves);
+    if (rootMoves.empty()) {
+        result.score = game.isInCheck(game.getCurrentPlayer()) ? -MATE_SCORE : 0;
+        return result;
+    }
+
+    // A covered ending is played from the tables without searching
+    if (bitbases) {
+        result.bestMove = bitbases->bestMove(game, result.score);
+        if (result.bestMove != Move()) {
+            result.depth = 1;
+            result.pv.push_back(result.bestMove);
+            result.timeMs = elapsedMs();
+            if (onIteration) onIteration(result);
+            return result;
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker->game = game;
+        worker->nodes.store(0, std::memory_order_relaxed);
+        worker->stopped = false;
+        worker->completed = SearchResult();
+        worker->ordering.newSearch();
+        worker->cutoffs = worker->firstMoveCutoffs = 0;
+        worker->ttProbes = worker->ttHits = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        runningHelpers = static_cast<int>(helpers.size());
+        searchId++;
+    }
+    wakeHelpers.notify_all();
+
+    workers[0]->iterate();
+
+    // The main thread is done; call the helpers off and wait for them
+    stopFlag.store(true, std::memory_order_relaxed);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        helpersDone.wait(lock, [&] { return runningHelpers == 0; });
+    }
+
+    // A helper that completed a deeper iteration knows better
+    const Worker* best = workers[0].get();
+    for (const auto& worker : workers) {
+        if (worker->completed.depth > best->completed.depth) best = worker.get();
+    }
+
+    result = best->completed;
+    // Stopped during the first iteration: any legal move beats none
+    if (result.bestMove == Move()) result.bestMove = rootMoves[0];
+    result.nodes = totalNodes();
+    result.cutoffs = workers[0]->cutoffs;
+    result.firstMoveCutoffs = workers[0]->firstMoveCutoffs;
+    for (const auto& worker : workers) {
+        result.ttProbes += worker->ttProbes;
+        result.ttHits += worker->ttHits;
+    }
+    result.timeMs = elapsedMs();
+    return result;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "movegen.h"
+#include "tt.h"
+
+class Bitbases;
+
+const int MAX_PLY = 128;
+static_assert(MAX_PLY <= SEARCH_PLY_RESERVE, "the undo stack must hold a full search line");
+
+// Score bounds; mate scores count plies from the root. A mate may lie up
+// to MAX_PLY plies into the search, plus a bitbase distance of up to 255
+// plies from where the table was probed.
+const int INFINITE_SCORE = 32001;
+const int MATE_SCORE = 32000;
+const int MATE_BOUND = MATE_SCORE - MAX_PLY - 256;
+
+// When to stop thinking; zero means no limit of that kind. Times are in
+// milliseconds; a clock is indexed by color and only the mover's is used.
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int movetime = 0;          // fixed time for this move
+    int time[2] = { 0, 0 };    // time left on each clock
+    int increment[2] = { 0, 0 };
+    int movesToGo = 0;         // moves until the next time control, 0 = sudden death
+    bool infinite = false;     // keep going until stop(), whatever is found
+    bool ponder = false;       // ignore the clock until ponderhit()
+};
+
+// Selective search techniques, each switchable so its effect on
+// time-to-depth and strength can be measured on its own
+struct SearchFeatures {
+    bool nullMove = true;            // null-move pruning
+    bool lateMoveReductions = true;
+    bool reverseFutility = true;     // static null-move pruning near the leaves
+    bool futility = true;            // skip hopeless quiet moves near the leaves
+    bool checkExtensions = true;
+
+    // Switch a feature by name: nullmove, lmr, rfp, futility or checkext.
+    // Returns false for an unknown name.
+    bool set(const std::string& name, bool enabled);
+};
+
+struct SearchResult {
+    Move bestMove;
+    int score = 0;
+    int depth = 0;            // last fully completed iteration
+    uint64_t nodes = 0;       // summed over all threads
+    uint64_t cutoffs = 0;             // beta cutoffs in the main thread
+    uint64_t firstMoveCutoffs = 0;    // of those, caused by the first move tried
+    uint64_t ttProbes = 0;            // transposition table probes, all threads
+    uint64_t ttHits = 0;
+    int64_t timeMs = 0;
+    MoveList pv;
+};
+
+// Iterative-deepening negamax alpha-beta with principal variation search
+// and aspiration windows. Independent of the GUI; several Search objects
+// may share one transposition table.
+//
+// With more than one thread the search is Lazy SMP: helper threads search
+// the same root at staggered depths and share only the transposition
+// table. The calling thread is always worker 0 and its result wins unless
+// a helper finished a deeper iteration.
+class Search {
+private:
+    struct Worker;
+
+    TranspositionTable& tt;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> helpers;
+    std::atomic<bool> stopFlag;
+
+    SearchLimits limits;
+    SearchFeatures features;
+    const Bitbases* bitbases;
+    std::atomic<bool> pondering;
+    bool armed;             // arm() was called for the next think()
+    std::function<void(const SearchResult&)> onIteration;
+    std::chrono::steady_clock::time_point startTime;
+    int64_t optimumTime;    // don't start another iteration after this
+    int64_t maximumTime;    // abort the search at this point
+    MoveList rootMoves;
+
+    // Helper threads sleep between searches until searchId changes
+    std::mutex mutex;
+    std::condition_variable wakeHelpers;
+    std::condition_variable helpersDone;
+    uint64_t searchId;
+    int runningHelpers;
+    bool quitting;
+
+    friend struct Worker;
+    bool shouldStop(const Worker& worker);
+    uint64_t totalNodes() const;
+    void allocateTime(Color us);
+    void helperLoop(Worker& worker, uint64_t lastSearch);
+    void stopHelpers();
+
+public:
+    explicit Search(TranspositionTable& table, int threads = 1);
+    ~Search();
+
+    Search(const Search&) = delete;
+    Search& operator=(const Search&) = delete;
+
+    // Number of search threads including the caller's; at least one
+    void setThreads(int threads);
+    int threadCount() const { return static_cast<int>(workers.size()); }
+
+    // Pruning, reduction and extension switches for the next think()
+    void setFeatures(const SearchFeatures& f) { features = f; }
+    const SearchFeatures& getFeatures() const { return features; }
+
+    // Endgame tables: a covered root position is played straight from them
+    // and covered positions in the tree are scored without searching.
+    // Null for none; the tables must outlive the search.
+    void setBitbases(const Bitbases* tables) { bitbases = tables; }
+
+    // Clear any earlier stop() and set pondering for the next think(), from
+    // the thread that will later call stop() or ponderhit(). A request
+    // that arrives before the search thread reaches think() is then kept;
+    // without arm(), think() clears both itself.
+    void arm(bool ponder);
+
+    // Search the game's current position until a limit is hit or stop()
+    SearchResult think(const Game& game, const SearchLimits& searchLimits);
+
+    // Ask a running think() to return as soon as possible (any thread)
+    void stop();
+
+    // The opponent played the pondered move: start obeying the clock,
+    // counted from the start of the search (any thread)
+    void ponderhit();
+
+    // Called on the searching thread after each completed iteration of the
+    // main thread, with nodes and time so far; not while think() runs
+    void setIterationCallback(std::function<void(const SearchResult&)> callback) { onIteration = std::move(callback); }
+
+    int64_t elapsedMs() const;
+};
@@ -0,0 +1,704 @@
+// Standalone consistency checks for the engine core (no SFML needed).
+// Build and run with: make check
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitbase.h"
+#include "bitboard.h"
+#include "book.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "notation.h"
+#include "pgn.h"
+#include "prng.h"
+#include "search.h"
+#include "tt.h"
+
+// Every heap allocation in this program is counted, so a check can assert
+// that a piece of code makes none
+static std::atomic<long> allocations(0);
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// ============= ATTACK TABLE CHECK =============
+
+// Naive ray walk over GUI coordinates, independent of the table builder
+static Bitboard walkAttacks(int sq, Bitboard occupied, bool diagonal) {
+    static const int straight[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    static const int diagonals[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    const int (*dirs)[2] = diagonal ? diagonals : straight;
+
+    Bitboard attacks = 0;
+    Position start = toPosition(sq);
+    for (int d = 0; d < 4; d++) {
+        Position p(start.row + dirs[d][0], start.col + dirs[d][1]);
+        while (p.isValid()) {
+            attacks |= squareBB(toSquare(p));
+            if (occupied & squareBB(toSquare(p))) break;
+            p = Position(p.row + dirs[d][0], p.col + dirs[d][1]);
+        }
+    }
+    return attacks;
+}
+
+#ifdef HAS_PEXT_INSTRUCTION
+// Bit-by-bit parallel extract used to validate the hardware instruction
+static Bitboard softwarePext(Bitboard src, Bitboard mask) {
+    Bitboard result = 0;
+    for (Bitboard bit = 1; mask; bit <<= 1) {
+        if (src & mask & -mask) result |= bit;
+        mask &= mask - 1;
+    }
+    return result;
+}
+#endif
+
+static bool checkAttackTables(bool pext, int samplesPerSquare) {
+    Attacks::build(pext);
+    const char* scheme = Attacks::usePext ? "pext" : "magic";
+
+    PRNG rng(0x5EEDULL);
+    long failures = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        for (int i = 0; i < samplesPerSquare; i++) {
+            // Mix sparse and dense boards so both short and long rays get hit
+            Bitboard occupied = (i & 1) ? rng.sparse() : rng.next();
+            occupied &= ~squareBB(sq);
+
+            if (Attacks::rook(sq, occupied) != walkAttacks(sq, occupied, false)) failures++;
+            if (Attacks::bishop(sq, occupied) != walkAttacks(sq, occupied, true)) failures++;
+            if (Attacks::queen(sq, occupied) != (walkAttacks(sq, occupied, false) | walkAttacks(sq, occupied, true))) {
+                failures++;
+            }
+#ifdef HAS_PEXT_INSTRUCTION
+            if (Attacks::usePext) {
+                Bitboard mask = Attacks::rookMagics[sq].mask;
+                if (Attacks::pext(occupied, mask) != softwarePext(occupied, mask)) failures++;
+            }
+#endif
+        }
+    }
+
+    std::cout << "attack tables (" << scheme << "): "
+              << 64L * samplesPerSquare << " occupancies per piece, "
+              << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= ZOBRIST AND EVALUATION CHECKS =============
+
+// Everything undoMove has to restore
+static bool sameState(const Game& a, const Game& b) {
+    for (int sq = 0; sq < 64; sq++) {
+        if (a.getBoard().pieceOn(sq) != b.getBoard().pieceOn(sq)) return false;
+    }
+    return a.getBoard().pieces() == b.getBoard().pieces()
+        && a.getCurrentPlayer() == b.getCurrentPlayer()
+        && a.getCastlingRights() == b.getCastlingRights()
+        && a.getEpSquare() == b.getEpSquare()
+        && a.getHalfmoveClock() == b.getHalfmoveClock()
+        && a.getKey() == b.getKey()
+        && a.getPsq() == b.getPsq()
+        && a.getPhase() == b.getPhase();
+}
+
+// Walk the move tree and compare the incremental key and evaluation
+// terms with a full recompute
+static long checkKeys(Game& game, int depth) {
+    long failures = game.getKey() != game.computeKey()
+                  || game.getPsq() != game.computePsq()
+                  || game.getPhase() != game.computePhase();
+    if (depth == 0) return failures;
+
+    MoveList moves;
+    generateMoves(game, moves);
+    Game before = game;
+    for (const Move& move : moves) {
+        game.makeMove(move);
+        failures += checkKeys(game, depth - 1);
+        game.undoMove();
+        failures += !sameState(game, before);
+    }
+
+    // A null move must come back just as exactly
+    if (!game.isInCheck(game.getCurrentPlayer())) {
+        game.makeNullMove();
+        game.undoNullMove();
+        failures += !sameState(game, before);
+    }
+    return failures;
+}
+
+static bool checkZobrist() {
+    const char* fens[] = {
+        START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+
+    // The piece-square tables must mirror exactly: the start position is level
+    long failures = Game().getPsq() != Score();
+    for (const char* fen : fens) {
+        Game game;
+        game.loadFEN(fen);
+        failures += checkKeys(game, 3);
+    }
+
+    std::cout << "zobrist keys, eval and undo: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= NOTATION CHECK =============
+
+// Every move in the tree must read back from its own SAN, and every
+// position must write out and reload as the same FEN
+static long checkNotationTree(Game& game, int depth) {
+    Game reloaded;
+    long failures = !reloaded.loadFEN(game.toFEN()) || reloaded.toFEN() != game.toFEN()
+                  || reloaded.getKey() != game.getKey();
+
+    MoveList moves;
+    generateMoves(game, moves);
+    for (const Move& move : moves) {
+        failures += parseSAN(game, moveToSAN(game, move)) != move;
+        if (depth > 1) {
+            game.makeMove(move);
+            failures += checkNotationTree(game, depth - 1);
+            game.undoMove();
+        }
+    }
+    return failures;
+}
+
+static bool checkNotation() {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 37",
+        "1N1N4/8/8/8/1N1N2k1/8/8/4K3 w - - 12 60",
+    };
+
+    long failures = 0;
+    for (const char* fen : fens) {
+        Game game;
+        game.loadFEN(fen);
+        failures += game.toFEN() != fen;
+        failures += checkNotationTree(game, 2);
+    }
+
+    // Spellings a suite or PGN file may use
+    Game game;
+    game.loadFEN("1N1N4/8/8/8/1N1N2k1/8/8/4K3 w - - 0 1");
+    failures += moveToSAN(game, parseSAN(game, "Nb8c6")) != "Nb8c6";
+    failures += parseSAN(game, "Nc6") != Move();
+    game.loadFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1");
+    failures += moveToString(parseSAN(game, "bxa1=Q+")) != "b2a1q";
+    failures += moveToString(parseSAN(game, "bxa1Q")) != "b2a1q";
+    failures += parseSAN(game, "bxa1=K") != Move();
+    failures += moveToString(parseSAN(game, "0-0-0")) != "e8c8";
+
+    // En passant fields on the wrong rank are refused, and ones without a
+    // just-pushed pawn behind them are dropped
+    failures += game.loadFEN("4k3/8/8/8/8/8/3P4/4K3 w - e3 0 1");
+    failures += !game.loadFEN("4k3/8/8/2PpP3/8/8/8/4K3 w - c6 0 1") || game.getEpSquare() != NO_SQUARE;
+    failures += !game.loadFEN("4k3/3p4/8/3pP3/8/8/8/4K3 w - d6 0 1") || game.getEpSquare() != NO_SQUARE;
+    failures += !game.loadFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1") || game.getEpSquare() != squareOf(5, 3);
+
+    std::cout << "FEN and SAN round trips: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= PGN CHECK =============
+
+// Counts what the reader hands over and remembers the last position
+struct CountingVisitor : PgnVisitor {
+    long tags = 0, moves = 0, complete = 0;
+    std::string lastFen;
+
+    void tag(std::string_view, std::string_view) override { tags++; }
+    void move(const Game&, Move) override { moves++; }
+    void endGame(const Game& game, std::string_view, bool ok) override {
+        complete += ok;
+        lastFen = game.toFEN();
+    }
+};
+
+static bool checkPgn() {
+    const char* pgn =
+        "% escape line\n"
+        "[Event \"a\"]\n[White \"Quote \\\" inside\"]\n\n"
+        "1.e4 e5 2.Bc4 {comment (not a variation)} Nc6 (2...Nf6 3.d3) 3.Qh5 Nf6?? $4 4.Qxf7# 1-0\n\n"
+        "[Event \"b\"]\n[FEN \"4k3/P7/8/8/8/8/8/4K3 w - - 0 1\"]\n\n"
+        "1. a8=Q+ Kd7 2. Qb7+ ; rest of line\nKd6 1/2-1/2\n"
+        "[Event \"c\"]\n1. e4 e5 2. Ke3 0-1\n"
+        "[Event \"d\"]\n1. d4 d5 2. c4 dxc3 *\n";
+
+    long failures = 0;
+    CountingVisitor whole;
+    PgnStats stats = readPgn(pgn, whole);
+    failures += stats.games != 4 || stats.moves != 16 || stats.errors != 2;
+    failures += whole.tags != 6 || whole.moves != 16 || whole.complete != 2;
+
+    // The same games read in pieces on several threads
+    CountingVisitor parts[3];
+    std::vector<PgnVisitor*> visitors = { &parts[0], &parts[1], &parts[2] };
+    PgnStats split = readPgnParallel(pgn, visitors);
+    failures += split.games != stats.games || split.moves != stats.moves || split.errors != stats.errors;
+
+    CountingVisitor last;
+    readPgn("[Event \"x\"]\n1. d4 Nf6 2. c4 e6 3. Nc3 Bb4 4. e3 O-O 5. Bd3 d5 6. cxd5 exd5 7. Nge2 Re8 *", last);
+    failures += last.lastFen != "rnbqr1k1/ppp2ppp/5n2/3p4/1b1P4/2NBP3/PP2NPPP/R1BQK2R w KQ - 2 8";
+
+    std::cout << "PGN reader: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= OPENING BOOK CHECK =============
+
+// Write a small book, map it back and probe it: entries must be found by
+// key, castling and promotions must decode, and picks must follow weights
+static bool checkBook() {
+    Game start;
+    Game castle;
+    castle.loadFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1");
+
+    struct Entry {
+        const Game* game;
+        const char* move;
+        uint16_t weight;
+    };
+    const Entry entries[] = {
+        { &start, "e2e4", 30 }, { &start, "d2d4", 10 }, { &start, "g1f3", 0 },
+        { &castle, "e8c8", 5 }, { &castle, "b2a1n", 7 },
+    };
+
+    std::vector<std::pair<uint64_t, uint16_t>> order;
+    for (const Entry& e : entries) order.push_back({ polyglotKey(*e.game), static_cast<uint16_t>(&e - entries) });
+    std::sort(order.begin(), order.end());
+
+    const char* path = "selfcheck_book.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        unsigned char bytes[OpeningBook::ENTRY_SIZE];
+        for (const auto& o : order) {
+            const Entry& e = entries[o.second];
+            writeBookEntry(bytes, o.first, encodeBookMove(parseMove(*e.game, e.move)), e.weight);
+            out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+    }
+
+    long failures = 0;
+    {
+        OpeningBook book(path);
+        failures += !book.isOpen() || book.size() != 5;
+
+        MoveList moves;
+        book.probe(castle, moves);
+        failures += moves.size() != 2;
+        for (size_t i = 0; i < moves.size(); i++) {
+            std::string text = moveToString(moves[i]);
+            failures += !(text == "e8c8" && moves.score(i) == 5) && !(text == "b2a1n" && moves.score(i) == 7);
+        }
+
+        int e4 = 0, d4 = 0;
+        PRNG rng(7);
+        for (int i = 0; i < 4000; i++) {
+            std::string text = moveToString(book.pick(start, rng.next()));
+            e4 += text == "e2e4";
+            d4 += text == "d2d4";
+        }
+        failures += e4 + d4 != 4000 || e4 < 2800 || e4 > 3200;
+
+        Game outOfBook;
+        outOfBook.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+        failures += book.pick(outOfBook, rng.next()) != Move();
+    }
+    std::remove(path);
+
+    std::cout << "opening book: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= BITBASE CHECK =============
+
+// Table indexing: every symmetric copy of a position (and every order of
+// identical men) has the same index, which decodes back to the position;
+// a table mapped from disk is probed with either color as the stronger side
+static bool checkBitbase() {
+    long failures = 0;
+    std::vector<std::string> names = bitbaseNames();
+    failures += names.size() != 35;
+    for (size_t i = 0; i < names.size(); i++) {
+        BitbaseLayout layout(names[i]);
+        failures += layout.count < 3 || std::find(names.begin(), names.begin() + i, names[i]) != names.begin() + i;
+    }
+
+    PRNG rng(2024);
+    for (const char* name : { "KRvKN", "KNNvK", "KPvKP" }) {
+        BitbaseLayout layout(name);
+        bool pawns = std::string(name).find('P') != std::string::npos;
+        for (int n = 0; n < 2000; n++) {
+            int squares[Bitbase::MAX_MEN];
+            for (int i = 0; i < layout.count; i++) squares[i] = static_cast<int>(rng.next() % 64);
+            Color toMove = (n & 1) ? Color::BLACK : Color::WHITE;
+            size_t index = layout.index(squares, toMove);
+
+            int mirrored[Bitbase::MAX_MEN], decoded[Bitbase::MAX_MEN];
+            for (int i = 0; i < layout.count; i++) {
+                int sq = pawns ? squares[i] ^ 7 : squareOf(fileOf(squares[i]), 7 - rankOf(squares[i]));
+                mirrored[(layout.pieces[2] == layout.pieces[3] && i >= 2) ? 5 - i : i] = sq;
+            }
+            Color decodedToMove;
+            failures += index >= layout.size || layout.index(mirrored, toMove) != index;
+            failures += !layout.decode(index, decoded, decodedToMove) || decodedToMove != toMove
+                     || layout.index(decoded, toMove) != index;
+        }
+    }
+
+    // A KQvK table whose entries follow their index
+    BitbaseLayout kqk("KQvK");
+    {
+        std::vector<unsigned char> bytes(Bitbases::HEADER_SIZE + kqk.size);
+        writeBitbaseHeader(bytes.data(), kqk.size);
+        for (size_t i = 0; i < kqk.size; i++) bytes[Bitbases::HEADER_SIZE + i] = static_cast<unsigned char>(i % 251);
+        std::ofstream out("KQvK.bb", std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    {
+        Bitbases tables;
+        failures += tables.load(".") != 1;
+
+        // Black's queen on c6 and king on h1 against a king on e8, White to
+        // move: the same as White's queen on c3 and king on h8, Black to move
+        Game game;
+        game.loadFEN("4K3/8/2q5/8/8/8/8/7k w - - 0 1");
+        EndgameMen men;
+        uint8_t entry = 0;
+        const int squares[] = { squareOf(7, 7), squareOf(0, 4), squareOf(2, 2) };
+        failures += !men.fromGame(game) || !tables.probe(men, entry)
+                 || entry != kqk.index(squares, Color::BLACK) % 251;
+
+        game.loadFEN("4k3/8/8/8/8/8/2R5/4K3 w - - 0 1");
+        failures += men.fromGame(game) && tables.probe(men, entry);
+
+        // The longest win an entry holds, probed at the deepest ply, still
+        // scores as a mate
+        int longSquares[Bitbase::MAX_MEN];
+        Color toMove;
+        size_t index = 250;
+        while (!kqk.decode(index, longSquares, toMove) || longSquares[0] == longSquares[1]
+               || longSquares[0] == longSquares[2] || longSquares[1] == longSquares[2]) {
+            index += 251;
+        }
+        Board board;
+        for (int i = 0; i < kqk.count; i++) board.putPiece(longSquares[i], kqk.pieces[i]);
+        game.setup(board, toMove);
+        int score = 0;
+        failures += !tables.probeScore(game, MAX_PLY - 1, score) || score != MATE_SCORE - (MAX_PLY - 1) - 249
+                 || score < MATE_BOUND;
+    }
+    std::remove("KQvK.bb");
+
+    // Tables where every KPvKP position is lost for the side to move in 30
+    // plies and every KPvK one drawn: a2-a4 lets bxa3 en passant draw, so
+    // it is the one move that does not win
+    for (const char* name : { "KPvKP", "KPvK" }) {
+        BitbaseLayout layout(name);
+        std::vector<unsigned char> bytes(Bitbases::HEADER_SIZE + layout.size, layout.count == 4 ? Bitbase::entryFor(30) : 0);
+        writeBitbaseHeader(bytes.data(), layout.size);
+        std::ofstream out(std::string(name) + ".bb", std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    {
+        Bitbases tables;
+        failures += tables.load(".") != 2;
+
+        Game game;
+        game.loadFEN("8/8/8/8/1p6/6k1/P7/K7 w - - 0 1");
+        Move push = parseSAN(game, "a4");
+        uint8_t entry = 1;
+        failures += !allowsEnPassant(game, push) || allowsEnPassant(game, parseSAN(game, "a3"))
+                 || !tables.probeEnPassant(game, push, entry) || entry != 0
+                 || game.getBoard().pieceOn(squareOf(1, 0)) != makePiece(Color::WHITE, PieceType::PAWN);
+
+        int score = 0;
+        Move best = tables.bestMove(game, score);
+        failures += best == Move() || best == push || score != MATE_SCORE - 31;
+    }
+    std::remove("KPvKP.bb");
+    std::remove("KPvK.bb");
+
+    std::cout << "bitbase indexing: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// ============= MOVE PICKER CHECK =============
+
+static bool contains(const MoveList& moves, Move move) {
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+// Drain a picker and compare with the generated list: same moves, once each
+static long checkPicked(MovePicker& picker, const MoveList& legal) {
+    MoveList picked;
+    Move move;
+    while (picker.next(move)) {
+        if (!contains(legal, move) || contains(picked, move)) return 1;
+        picked.push_back(move);
+    }
+    return picked.size() != legal.size();
+}
+
+// At every node, try the same side's moves from two plies up as hash move
+// and killers, and check isLegal against the generator for them
+static long checkPickerTree(Game& game, const MoveList& parentMoves, const MoveList& earlierMoves,
+                            OrderingTables& tables, int ply, int depth) {
+    MoveList legal;
+    generateMoves(game, legal);
+
+    long failures = 0;
+    for (const Move& move : earlierMoves) {
+        failures += isLegal(game, move) != contains(legal, move);
+    }
+    for (const Move& move : legal) {
+        failures += !isLegal(game, move);
+    }
+
+    MovePicker plain(game);
+    failures += checkPicked(plain, legal);
+
+    Move ttMove = earlierMoves.empty() ? Move() : earlierMoves[ply % earlierMoves.size()];
+    tables.killers[ply][0] = earlierMoves.empty() ? Move() : earlierMoves.back();
+    tables.killers[ply][1] = legal.empty() ? Move() : legal[legal.size() / 2];
+    MovePicker ordered(game, ttMove, tables, ply);
+    failures += checkPicked(ordered, legal);
+
+    if (depth == 0) return failures;
+    for (const Move& move : legal) {
+        game.makeMove(move);
+        failures += checkPickerTree(game, legal, parentMoves, tables, ply + 1, depth - 1);
+        game.undoMove();
+    }
+    return failures;
+}
+
+static bool checkMovePicker() {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    };
+
+    auto tables = std::make_unique<OrderingTables>();
+    long failures = 0;
+    for (const char* fen : fens) {
+        Game game;
+        game.loadFEN(fen);
+        failures += checkPickerTree(game, MoveList(), MoveList(), *tables, 0, 3);
+    }
+
+    std::cout << "move picker and isLegal: " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+// Exchanges with known outcomes, including x-rays, en passant and a king
+// that cannot recapture into a defended square
+static bool checkSee() {
+    struct Case {
+        const char* fen;
+        const char* move;
+        int expected;
+    };
+    const Case cases[] = {
+        { "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5", PAWN_VALUE },
+        { "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5", PAWN_VALUE - KNIGHT_VALUE },
+        { "4k3/8/2p5/3p4/4P3/8/8/4K3 w - - 0 1", "e4d5", 0 },
+        { "3rk3/8/8/3r4/8/8/3R4/3RK3 w - - 0 1", "d2d5", ROOK_VALUE },
+        { "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", PAWN_VALUE },
+        { "4k3/8/8/8/8/2b5/3q4/3QK3 w - - 0 1", "d1d2", BISHOP_VALUE },
+        { "4k3/8/8/8/1b6/2b5/3q4/3QK3 w - - 0 1", "d1d2", 0 },
+        { "4k3/8/8/8/8/8/8/4K2R w K - 0 1", "e1g1", 0 },
+    };
+
+    long failures = 0;
+    for (const Case& c : cases) {
+        Game game;
+        game.loadFEN(c.fen);
+        MoveList moves;
+        generateMoves(game, moves);
+
+        bool found = false;
+        for (const Move& move : moves) {
+            if (moveToString(move) != c.move) continue;
+            found = true;
+            if (see(game, move) != c.expected) {
+                std::cout << "  see " << c.move << " in " << c.fen << ": " << see(game, move)
+                          << ", expected " << c.expected << "\n";
+                failures++;
+            }
+        }
+        failures += !found;
+    }
+
+    std::cout << "static exchange evaluation: " << failures << " wrong results\n";
+    return failures == 0;
+}
+
+// ============= TRANSPOSITION TABLE CHECK =============
+
+static bool checkTranspositionTable() {
+    TranspositionTable tt(1);
+    long failures = 0;
+
+    Move promotion(squareOf(6, 0), squareOf(7, 1), MoveType::PROMOTION, PieceType::KNIGHT);
+    tt.store(0x1234567890ABCDEFULL, promotion, -31000, -250, 17, Bound::LOWER);
+    tt.store(0x0FEDCBA987654321ULL, Move(squareOf(0, 4), squareOf(0, 6), MoveType::CASTLING), 42, 7, 3, Bound::EXACT);
+
+    TTData data;
+    failures += !tt.probe(0x1234567890ABCDEFULL, data);
+    failures += !(data.move == promotion) || data.score != -31000 || data.eval != -250
+              || data.depth != 17 || data.bound != Bound::LOWER;
+    failures += !tt.probe(0x0FEDCBA987654321ULL, data);
+    failures += data.move.type() != MoveType::CASTLING || data.score != 42 || data.bound != Bound::EXACT;
+    failures += tt.probe(0x1111111111111111ULL, data);
+
+    std::cout << "transposition table: " << failures << " round-trip errors\n";
+    return failures == 0;
+}
+
+// ============= STOP CHECK =============
+
+// A stop() between arm() and think(), as when "stop" follows "go infinite"
+// at once, must end the search instead of being cleared by it
+static bool checkImmediateStop() {
+    TranspositionTable tt(16);
+    Search search(tt, 2);
+    Game game;
+
+    SearchLimits limits;
+    limits.infinite = true;
+
+    std::atomic<bool> done(false);
+    SearchResult result;
+    search.arm(false);
+    search.stop();
+    std::thread searcher([&] {
+        result = search.think(game, limits);
+        done = true;
+    });
+
+    // Give it a second, then stop it for good so a failure does not hang
+    for (int i = 0; i < 1000 && !done; i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    bool stoppedInTime = done;
+    while (!done) {
+        search.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    searcher.join();
+
+    bool legal = isLegal(game, result.bestMove);
+    std::cout << "immediate stop: " << (stoppedInTime ? "returned" : "ignored") << ", best move "
+              << (legal ? moveToString(result.bestMove) : "missing") << "\n";
+    return stoppedInTime && legal;
+}
+
+// A clock at zero while the opponent's still runs, as in "go wtime 0
+// btime 1000", must make the search move at once instead of running on
+static bool checkEmptyClock() {
+    TranspositionTable tt(16);
+    Search search(tt, 2);
+    Game game;
+
+    SearchLimits limits;
+    limits.time[toIndex(Color::WHITE)] = 0;
+    limits.time[toIndex(Color::BLACK)] = 1000;
+
+    std::atomic<bool> done(false);
+    SearchResult result;
+    std::thread searcher([&] {
+        result = search.think(game, limits);
+        done = true;
+    });
+
+    for (int i = 0; i < 1000 && !done; i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    bool movedInTime = done;
+    while (!done) {
+        search.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    searcher.join();
+
+    bool legal = isLegal(game, result.bestMove);
+    std::cout << "empty clock: " << (movedInTime ? "moved" : "kept searching") << ", best move "
+              << (legal ? moveToString(result.bestMove) : "missing") << "\n";
+    return movedInTime && legal;
+}
+
+// ============= ALLOCATION CHECK =============
+
+// Move generation, make/unmake and a whole fixed-depth search must run
+// without touching the heap once the tables and threads exist
+static bool checkNoAllocations() {
+    TranspositionTable tt(16);
+    Search search(tt, 1);
+    Game game;
+    game.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    SearchLimits limits;
+    limits.depth = 8;
+
+    long before = allocations.load();
+    SearchResult result = search.think(game, limits);
+    long used = allocations.load() - before;
+
+    std::cout << "allocations: " << used << " in a depth " << result.depth << " search of "
+              << result.nodes << " nodes, " << result.ttHits << " of " << result.ttProbes << " table probes hit\n";
+    return used == 0 && result.depth == limits.depth && result.ttHits > 0 && result.ttHits <= result.ttProbes;
+}
+
+int main() {
+    bool ok = true;
+
+    ok &= checkAttackTables(false, 20000);
+    if (Attacks::cpuHasPext()) {
+        ok &= checkAttackTables(true, 20000);
+    } else {
+        std::cout << "attack tables (pext): skipped, CPU has no BMI2\n";
+    }
+
+    ok &= checkZobrist();
+    ok &= checkNotation();
+    ok &= checkPgn();
+    ok &= checkBook();
+    ok &= checkBitbase();
+    ok &= checkMovePicker();
+    ok &= checkSee();
+    ok &= checkTranspositionTable();
+    ok &= checkImmediateStop();
+    ok &= checkEmptyClock();
+    ok &= checkNoAllocations();
+
+    std::cout << (ok ? "All checks passed\n" : "CHECKS FAILED\n");
+    return ok ? 0 : 1;
+}
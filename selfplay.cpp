@@ -0,0 +1,320 @@
+// Self-play: engine-vs-engine games on a pool of worker threads, reporting
+// how engine A does against engine B as an Elo difference with error bars
+// and a running SPRT verdict, without SFML.
+//
+//   selfplay [--games n] [--concurrency n] [--openings file] [--maxmoves n]
+//            [--elo0 x] [--elo1 x] [--alpha x] [--beta x]
+//            [--nodes n] [--depth n] [--movetime ms] [--hash MB] [--disable <feature>]
+//            [--a-<option> value]... [--b-<option> value]...
+//
+// Each worker plays one game at a time with a single-threaded search per
+// side, so throughput grows with the number of workers (default: all
+// cores). The search options set both engines; the --a- and --b- forms set
+// one side only, e.g. "--b-disable lmr" to measure late move reductions.
+// The default limit is a node count per move, which keeps games
+// independent of machine load.
+//
+// Every opening is played twice with colors reversed. Openings come from a
+// file of FEN or EPD lines, or from the built-in set. Games end on mate,
+// stalemate, threefold repetition, the fifty-move rule, bare kings or a
+// minor piece against a bare king, or after --maxmoves moves (a draw).
+// Play stops early once the SPRT of elo0 against elo1 accepts either.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "movegen.h"
+#include "notation.h"
+#include "search.h"
+
+namespace {
+
+// Short lines from common openings, in coordinate notation
+const char* const OPENING_LINES[] = {
+    "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6",
+    "e2e4 e7e5 g1f3 b8c6 f1c4 f8c5",
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4",
+    "e2e4 c7c5 b1c3 b8c6 g2g3 g7g6",
+    "e2e4 e7e6 d2d4 d7d5 b1c3 g8f6",
+    "e2e4 c7c6 d2d4 d7d5 e4e5 c8f5",
+    "e2e4 d7d6 d2d4 g8f6 b1c3 g7g6",
+    "e2e4 d7d5 e4d5 d8d5 b1c3 d5a5",
+    "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6",
+    "d2d4 d7d5 c2c4 c7c6 g1f3 g8f6",
+    "d2d4 g8f6 c2c4 g7g6 b1c3 f8g7",
+    "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4",
+    "d2d4 g8f6 c2c4 c7c5 d4d5 e7e6",
+    "d2d4 f7f5 g2g3 g8f6 f1g2 g7g6",
+    "c2c4 e7e5 b1c3 g8f6 g1f3 b8c6",
+    "c2c4 c7c5 g1f3 g8f6 b1c3 b8c6",
+    "g1f3 d7d5 g2g3 g8f6 f1g2 c7c6",
+    "g1f3 g8f6 c2c4 b7b6 g2g3 c8b7",
+    "e2e4 e7e5 f2f4 e5f4 g1f3 g7g5",
+    "d2d4 d7d5 c1f4 g8f6 e2e3 c7c5",
+};
+
+// How one side searches each move
+struct EngineConfig {
+    SearchLimits limits;
+    size_t hashMB = 8;
+    SearchFeatures features;
+};
+
+enum class Outcome { A_WINS, DRAW, B_WINS };
+
+// Wins, draws and losses from engine A's point of view
+struct Tally {
+    long wins = 0;
+    long draws = 0;
+    long losses = 0;
+
+    long games() const { return wins + draws + losses; }
+};
+
+// One engine: its own table and a single-threaded search
+struct Player {
+    TranspositionTable tt;
+    Search search;
+    SearchLimits limits;
+
+    explicit Player(const EngineConfig& config) : tt(config.hashMB), search(tt, 1), limits(config.limits) {
+        search.setFeatures(config.features);
+    }
+};
+
+// Kings alone, or a lone bishop or knight besides them, cannot mate
+bool insufficientMaterial(const Board& board) {
+    if (board.pieces(PieceType::PAWN) | board.pieces(PieceType::ROOK) | board.pieces(PieceType::QUEEN)) return false;
+    return popCount(board.pieces(PieceType::KNIGHT) | board.pieces(PieceType::BISHOP)) <= 1;
+}
+
+// Play one game from the opening; white is engine A when aIsWhite
+Outcome playGame(const Game& opening, Player& a, Player& b, bool aIsWhite, int maxMoves) {
+    Game game = opening;
+    a.tt.clear();
+    b.tt.clear();
+
+    // Keys since the last capture or pawn move, for threefold repetition
+    std::vector<uint64_t> keys;
+    keys.reserve(128);
+    keys.push_back(game.getKey());
+
+    auto outcomeFor = [&](Color winner) {
+        return (winner == Color::WHITE) == aIsWhite ? Outcome::A_WINS : Outcome::B_WINS;
+    };
+
+    for (int ply = 0; ply < 2 * maxMoves; ply++) {
+        Color us = game.getCurrentPlayer();
+        if (!game.hasLegalMoves()) {
+            return game.isInCheck(us) ? outcomeFor(~us) : Outcome::DRAW;
+        }
+        if (game.getHalfmoveClock() >= 100 || insufficientMaterial(game.getBoard())) return Outcome::DRAW;
+        if (std::count(keys.begin(), keys.end(), game.getKey()) >= 3) return Outcome::DRAW;
+
+        Player& player = ((us == Color::WHITE) == aIsWhite) ? a : b;
+        SearchResult result = player.search.think(game, player.limits);
+        game.makeMove(result.bestMove);
+
+        if (game.getHalfmoveClock() == 0) keys.clear();
+        keys.push_back(game.getKey());
+    }
+    return Outcome::DRAW;
+}
+
+// ============= STATISTICS =============
+
+// Expected score for an Elo difference, and the reverse
+double scoreOf(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+double eloOf(double score) { return -400.0 * std::log10(1.0 / score - 1.0); }
+
+double meanScore(const Tally& t) {
+    return (t.wins + 0.5 * t.draws) / t.games();
+}
+
+// Variance of a single game's score around the mean
+double scoreVariance(const Tally& t) {
+    double s = meanScore(t);
+    return (t.wins * (1 - s) * (1 - s) + t.draws * (0.5 - s) * (0.5 - s) + t.losses * s * s) / t.games();
+}
+
+// Elo and its 95% confidence interval half-width
+void estimateElo(const Tally& t, double& elo, double& margin) {
+    double s = meanScore(t);
+    double deviation = 1.96 * std::sqrt(scoreVariance(t) / t.games());
+    double low = std::max(s - deviation, 1e-6), high = std::min(s + deviation, 1 - 1e-6);
+    elo = eloOf(std::min(std::max(s, 1e-6), 1 - 1e-6));
+    margin = (eloOf(high) - eloOf(low)) / 2;
+}
+
+// Games before the variance estimate is trusted for the SPRT
+const int SPRT_MIN_GAMES = 16;
+
+// Log-likelihood ratio of elo1 over elo0 under the normal approximation;
+// zero for the first few games and while every result is the same
+double sprtLLR(const Tally& t, double elo0, double elo1) {
+    double variance = scoreVariance(t);
+    if (t.games() < SPRT_MIN_GAMES || variance <= 0) return 0.0;
+    double s0 = scoreOf(elo0), s1 = scoreOf(elo1);
+    return t.games() * (s1 - s0) * (2 * meanScore(t) - s0 - s1) / (2 * variance);
+}
+
+struct Sprt {
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+
+    double lowerBound() const { return std::log(beta / (1 - alpha)); }
+    double upperBound() const { return std::log((1 - beta) / alpha); }
+};
+
+void report(const Tally& t, const Sprt& sprt, double llr) {
+    double elo, margin;
+    estimateElo(t, elo, margin);
+    std::cout << "Games " << std::setw(6) << t.games() << ": +" << t.wins << " =" << t.draws << " -" << t.losses
+              << std::fixed << std::setprecision(1) << "  Elo " << elo << " +/- " << margin
+              << std::setprecision(2) << "  LLR " << llr << " [" << sprt.lowerBound() << ", "
+              << sprt.upperBound() << "]\n";
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// ============= OPTIONS =============
+
+// Apply one search option to a side; false if the name is not one
+bool applyOption(EngineConfig& config, const std::string& name, const std::string& value) {
+    if (name == "nodes") config.limits.nodes = std::strtoull(value.c_str(), nullptr, 10);
+    else if (name == "depth") config.limits.depth = std::atoi(value.c_str());
+    else if (name == "movetime") config.limits.movetime = std::atoi(value.c_str());
+    else if (name == "hash") config.hashMB = std::max<size_t>(std::strtoul(value.c_str(), nullptr, 10), 1);
+    else if (name == "disable") return config.features.set(value, false);
+    else return false;
+    return true;
+}
+
+bool loadOpenings(const std::string& path, std::vector<Game>& openings) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        Game game;
+        if (!line.empty() && game.loadFEN(line)) openings.push_back(game);
+    }
+    return !openings.empty();
+}
+
+void builtinOpenings(std::vector<Game>& openings) {
+    for (const char* line : OPENING_LINES) {
+        Game game;
+        std::istringstream moves(line);
+        std::string text;
+        while (moves >> text) game.makeMove(parseMove(game, text));
+        openings.push_back(game);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    EngineConfig configs[2];
+    for (EngineConfig& config : configs) config.limits.nodes = 20000;
+
+    long totalGames = 1000;
+    int concurrency = std::max(1u, std::thread::hardware_concurrency());
+    int maxMoves = 200;
+    std::string openingsPath;
+    Sprt sprt;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0 || i + 1 >= argc) {
+            std::cerr << "Expected --<option> <value>, got " << arg << "\n";
+            return 1;
+        }
+        std::string name = arg.substr(2), value = argv[++i];
+
+        if (name == "games") totalGames = std::max(2L, std::atol(value.c_str()));
+        else if (name == "concurrency") concurrency = std::max(1, std::atoi(value.c_str()));
+        else if (name == "maxmoves") maxMoves = std::min(std::max(1, std::atoi(value.c_str())), MAX_GAME_PLIES / 2);
+        else if (name == "openings") openingsPath = value;
+        else if (name == "elo0") sprt.elo0 = std::atof(value.c_str());
+        else if (name == "elo1") sprt.elo1 = std::atof(value.c_str());
+        else if (name == "alpha") sprt.alpha = std::atof(value.c_str());
+        else if (name == "beta") sprt.beta = std::atof(value.c_str());
+        else if (name.compare(0, 2, "a-") == 0 || name.compare(0, 2, "b-") == 0) {
+            if (!applyOption(configs[name[0] == 'b'], name.substr(2), value)) {
+                std::cerr << "Unknown engine option: " << arg << " " << value << "\n";
+                return 1;
+            }
+        } else if (!applyOption(configs[0], name, value) || !applyOption(configs[1], name, value)) {
+            std::cerr << "Unknown option: " << arg << " " << value << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Game> openings;
+    if (openingsPath.empty()) {
+        builtinOpenings(openings);
+    } else if (!loadOpenings(openingsPath, openings)) {
+        std::cerr << "No positions in " << openingsPath << "\n";
+        return 1;
+    }
+
+    std::cout << totalGames << " games on " << concurrency << " threads from " << openings.size()
+              << " openings, SPRT elo0 " << sprt.elo0 << " elo1 " << sprt.elo1
+              << " alpha " << sprt.alpha << " beta " << sprt.beta << "\n";
+
+    // Workers claim game numbers in order; game 2k and 2k+1 share an opening
+    std::atomic<long> nextGame(0);
+    std::atomic<bool> finished(false);
+    std::mutex tallyMutex;
+    Tally tally;
+    long reportEvery = std::max(1L, std::min(100L, totalGames / 20));
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < concurrency; w++) {
+        workers.emplace_back([&] {
+            Player a(configs[0]), b(configs[1]);
+            for (long n; !finished.load() && (n = nextGame.fetch_add(1)) < totalGames;) {
+                const Game& opening = openings[(n / 2) % openings.size()];
+                Outcome outcome = playGame(opening, a, b, n % 2 == 0, maxMoves);
+
+                std::lock_guard<std::mutex> lock(tallyMutex);
+                if (finished) break;
+                if (outcome == Outcome::A_WINS) tally.wins++;
+                else if (outcome == Outcome::B_WINS) tally.losses++;
+                else tally.draws++;
+
+                double llr = sprtLLR(tally, sprt.elo0, sprt.elo1);
+                bool decided = llr <= sprt.lowerBound() || llr >= sprt.upperBound();
+                if (decided || tally.games() % reportEvery == 0 || tally.games() == totalGames) {
+                    report(tally, sprt, llr);
+                }
+                if (decided) finished = true;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double llr = sprtLLR(tally, sprt.elo0, sprt.elo1);
+    std::cout << "SPRT: " << (llr >= sprt.upperBound() ? "H1 accepted (A is stronger by elo1)"
+                            : llr <= sprt.lowerBound() ? "H0 accepted (A is not stronger by elo1)"
+                                                       : "inconclusive")
+              << "\n" << tally.games() << " games in " << std::fixed << std::setprecision(1) << seconds << " s ("
+              << tally.games() / seconds << " games/s)\n";
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "tt.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Data word layout (low to high bits):
+//   move 16 | score 16 | eval 16 | depth 8 | bound 2 | generation 6
+const int GENERATION_BITS = 6;
+const uint8_t GENERATION_MASK = (1 << GENERATION_BITS) - 1;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+uint64_t packData(Move move, int score, int eval, int depth, Bound bound, uint8_t generation) {
+    return uint64_t(move.raw())
+         | uint64_t(uint16_t(int16_t(score))) << 16
+         | uint64_t(uint16_t(int16_t(eval))) << 32
+         | uint64_t(uint8_t(int8_t(depth))) << 48
+         | uint64_t(static_cast<uint8_t>(bound)) << 56
+         | uint64_t(generation & GENERATION_MASK) << 58;
+}
+
+int depthOf(uint64_t data) { return int8_t(data >> 48); }
+uint8_t generationOf(uint64_t data) { return uint8_t(data >> 58); }
+bool isEmpty(uint64_t data) { return static_cast<Bound>((data >> 56) & 3) == Bound::NONE; }
+
+} // namespace
+
+// ============= TRANSPOSITION TABLE =============
+
+TranspositionTable::TranspositionTable(size_t megabytes, bool useHugePages)
+    : buckets(nullptr), bucketCount(0), allocatedBytes(0), hugePages(false), generation(0) {
+    resize(megabytes, useHugePages);
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+void TranspositionTable::release() {
+    if (!buckets) return;
+#ifdef __linux__
+    if (hugePages) {
+        munmap(buckets, allocatedBytes);
+        buckets = nullptr;
+        return;
+    }
+#endif
+    std::free(buckets);
+    buckets = nullptr;
+}
+
+// Reallocate to the given size; optionally ask the OS for huge pages
+void TranspositionTable::resize(size_t megabytes, bool useHugePages) {
+    release();
+
+    size_t bytes = (megabytes ? megabytes : 1) << 20;
+    bucketCount = bytes / sizeof(Bucket);
+    allocatedBytes = bucketCount * sizeof(Bucket);
+    hugePages = false;
+
+#ifdef __linux__
+    if (useHugePages) {
+        // Round up to whole huge pages and ask for transparent huge pages
+        allocatedBytes = (allocatedBytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* mem = mmap(nullptr, allocatedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+            madvise(mem, allocatedBytes, MADV_HUGEPAGE);
+#endif
+            buckets = static_cast<Bucket*>(mem);
+            hugePages = true;
+        } else {
+            allocatedBytes = bucketCount * sizeof(Bucket);
+        }
+    }
+#else
+    (void)useHugePages;
+#endif
+
+    if (!buckets) {
+        buckets = static_cast<Bucket*>(std::aligned_alloc(alignof(Bucket), allocatedBytes));
+        if (!buckets) throw std::bad_alloc();
+    }
+
+    clear();
+}
+
+// Forget every entry
+void TranspositionTable::clear() {
+    std::memset(static_cast<void*>(buckets), 0, bucketCount * sizeof(Bucket));
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & GENERATION_MASK;
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const {
+    // Map the key onto [0, bucketCount) without needing a power of two
+    return buckets[static_cast<size_t>((static_cast<unsigned __int128>(key) * bucketCount) >> 64)];
+}
+
+void TranspositionTable::prefetch(uint64_t key) const {
+    __builtin_prefetch(&bucketFor(key));
+}
+
+// Look up a position; fills out and returns true on a hit
+bool TranspositionTable::probe(uint64_t key, TTData& out) {
+    Bucket& bucket = bucketFor(key);
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || isEmpty(data)) continue;
+
+        out.move = Move::fromRaw(uint16_t(data));
+        out.score = int16_t(data >> 16);
+        out.eval = int16_t(data >> 32);
+        out.depth = depthOf(data);
+        out.bound = static_cast<Bound>((data >> 56) & 3);
+        return true;
+    }
+    return false;
+}
+
+// Save a search result, replacing the least valuable entry in the bucket
+void TranspositionTable::store(uint64_t key, Move move, int score, int eval, int depth, Bound bound) {
+    Bucket& bucket = bucketFor(key);
+    Entry* replace = &bucket.entries[0];
+    int worstValue = 1 << 30;
+
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        bool sameKey = (entry.check.load(std::memory_order_relaxed) ^ data) == key;
+
+        if (sameKey || isEmpty(data)) {
+            // Keep the old best move if this result has none
+            if (sameKey && move == Move()) move = Move::fromRaw(uint16_t(data));
+            // Don't let a shallow bound overwrite a deeper result for the same position
+            if (sameKey && bound != Bound::EXACT && depthOf(data) > depth + 2
+                && generationOf(data) == generation) {
+                return;
+            }
+            replace = &entry;
+            break;
+        }
+
+        // Older generations and shallower depths are cheaper to lose
+        int age = (generation - generationOf(data)) & GENERATION_MASK;
+        int value = depthOf(data) - 8 * age;
+        if (value < worstValue) {
+            worstValue = value;
+            replace = &entry;
+        }
+    }
+
+    uint64_t data = packData(move, score, eval, depth, bound, generation);
+    replace->data.store(data, std::memory_order_relaxed);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+// Permille of sampled entries written during the current search
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    size_t sample = bucketCount < 250 ? bucketCount : 250;
+    for (size_t i = 0; i < sample; i++) {
+        for (const Entry& entry : buckets[i].entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            used += !isEmpty(data) && generationOf(data) == generation;
+        }
+    }
+    return sample ? static_cast<int>(used * 1000 / (sample * 4)) : 0;
+}
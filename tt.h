@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "game.h"
+
+// Which side of the search window a stored score is known to be on
+enum class Bound : uint8_t {
+    NONE, UPPER, LOWER, EXACT
+};
+
+// Unpacked contents of one table entry
+struct TTData {
+    Move move;
+    int score;
+    int eval;
+    int depth;
+    Bound bound;
+};
+
+// Transposition table shared by every search thread without locks.
+// Entries store key ^ data next to data, so a torn write from another
+// thread just reads as a miss. Four 16-byte entries fill one cache line.
+class TranspositionTable {
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;   // key ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    Bucket* buckets;
+    size_t bucketCount;
+    size_t allocatedBytes;
+    bool hugePages;
+    uint8_t generation;
+
+    Bucket& bucketFor(uint64_t key) const;
+    void release();
+
+public:
+    explicit TranspositionTable(size_t megabytes = 16, bool useHugePages = false);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Reallocate to the given size; optionally ask the OS for huge pages
+    void resize(size_t megabytes, bool useHugePages = false);
+
+    // Forget every entry
+    void clear();
+
+    // Age existing entries so a new search prefers to overwrite them
+    void newSearch();
+
+    // Look up a position; fills out and returns true on a hit
+    bool probe(uint64_t key, TTData& out);
+
+    // Save a search result, replacing the least valuable entry in the bucket
+    void store(uint64_t key, Move move, int score, int eval, int depth, Bound bound);
+
+    // Hint the CPU to fetch a position's bucket ahead of the probe
+    void prefetch(uint64_t key) const;
+
+    size_t sizeMB() const { return allocatedBytes >> 20; }
+    bool usesHugePages() const { return hugePages; }
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+// Enums for piece types and colors
+enum class PieceType {
+    PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING, NONE
+};
+
+enum class Color {
+    WHITE, BLACK, NONE
+};
+
+// Position structure to represent board coordinates
+// (row 0 is the eighth rank, as drawn at the top of the window)
+struct Position {
+    int row;
+    int col;
+
+    Position(int r = 0, int c = 0) : row(r), col(c) {}
+    bool isValid() const{
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+    bool operator==(const Position& other) const {
+        return row == other.row && col == other.col;
+    }
+};
+
+// ============= BITBOARD BASICS =============
+
+// One bit per square, a1 = bit 0, h1 = bit 7, h8 = bit 63
+using Bitboard = uint64_t;
+
+const int NO_SQUARE = 64;
+
+constexpr int squareOf(int rank, int file) { return rank * 8 + file; }
+constexpr int rankOf(int sq) { return sq >> 3; }
+constexpr int fileOf(int sq) { return sq & 7; }
+constexpr Bitboard squareBB(int sq) { return Bitboard(1) << sq; }
+
+// Convert between GUI coordinates and square indices
+inline int toSquare(Position pos) { return squareOf(7 - pos.row, pos.col); }
+inline Position toPosition(int sq) { return Position(7 - rankOf(sq), fileOf(sq)); }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+
+// Return and clear the least significant set square
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+constexpr int toIndex(PieceType t) { return static_cast<int>(t); }
+constexpr int toIndex(Color c) { return static_cast<int>(c); }
+constexpr Color operator~(Color c) { return c == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+// ============= PIECE CODES =============
+
+// Plain piece value stored in the board mailbox: color * 6 + type
+using PieceCode = uint8_t;
+
+const PieceCode NO_PIECE = 12;
+
+constexpr PieceCode makePiece(Color c, PieceType t) {
+    return static_cast<PieceCode>(toIndex(c) * 6 + toIndex(t));
+}
+
+constexpr PieceType typeOf(PieceCode p) {
+    return p == NO_PIECE ? PieceType::NONE : static_cast<PieceType>(p % 6);
+}
+
+constexpr Color colorOf(PieceCode p) {
+    return p == NO_PIECE ? Color::NONE : static_cast<Color>(p / 6);
+}
@@ -0,0 +1,325 @@
+// UCI front end: speaks the Universal Chess Interface on stdin/stdout so
+// match runners and analysis GUIs can drive the engine, without SFML.
+//
+//   position [startpos | fen <fen>] [moves <move>...]
+//   go [depth n] [nodes n] [movetime ms] [wtime ms] [btime ms] [winc ms]
+//      [binc ms] [movestogo n] [infinite] [ponder]
+//   stop, ponderhit, isready, ucinewgame, setoption, quit
+//
+// The main thread only reads commands. Each "go" searches on a thread of
+// its own, so "stop", "ponderhit" and "isready" are handled at once while
+// a search runs; the search polls the stop flag at every node.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "bitbase.h"
+#include "book.h"
+#include "game.h"
+#include "notation.h"
+#include "prng.h"
+#include "search.h"
+
+namespace {
+
+const size_t DEFAULT_HASH_MB = 16;
+const size_t MAX_HASH_MB = 65536;
+const int MAX_THREADS = 256;
+
+// Search switches offered as check options, with their SearchFeatures name
+struct FeatureOption {
+    const char* option;
+    const char* feature;
+};
+
+const FeatureOption FEATURE_OPTIONS[] = {
+    { "NullMove", "nullmove" },
+    { "LateMoveReductions", "lmr" },
+    { "ReverseFutility", "rfp" },
+    { "Futility", "futility" },
+    { "CheckExtensions", "checkext" },
+};
+
+// Score as "cp <n>" or "mate <moves>", negative when the engine is mated
+std::string formatScore(int score) {
+    if (std::abs(score) < MATE_BOUND) return "cp " + std::to_string(score);
+    int plies = MATE_SCORE - std::abs(score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+class UciEngine {
+private:
+    Game game;
+    TranspositionTable tt;
+    Search search;
+    std::thread searchThread;
+
+    // With OwnBook on, positions in the book are answered without a search
+    std::unique_ptr<OpeningBook> book;
+    bool ownBook = false;
+    PRNG bookRandom;
+
+    // Endgame tables from BitbasePath, played from and probed in the search
+    std::unique_ptr<Bitbases> bitbases;
+
+    // Every line to the GUI goes out whole, from whichever thread
+    std::mutex outputMutex;
+
+    // An infinite or pondering search that ends by itself must hold its
+    // bestmove until "stop" or "ponderhit" releases it
+    std::mutex releaseMutex;
+    std::condition_variable released;
+    bool holdBestMove = false;
+
+    void send(const std::string& line);
+
+    void stopSearch();
+    void releaseBestMove();
+
+    void setPosition(std::istringstream& args);
+    void setOption(std::istringstream& args);
+    void go(std::istringstream& args);
+    void reportIteration(const SearchResult& result);
+
+public:
+    UciEngine();
+    ~UciEngine();
+
+    // Read and answer commands until "quit" or end of input
+    void loop();
+};
+
+UciEngine::UciEngine()
+    : tt(DEFAULT_HASH_MB), search(tt, 1), bookRandom(std::chrono::steady_clock::now().time_since_epoch().count() | 1) {
+    search.setIterationCallback([this](const SearchResult& result) { reportIteration(result); });
+}
+
+UciEngine::~UciEngine() {
+    stopSearch();
+}
+
+void UciEngine::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+// End a running search and join its thread. A held best move is released
+// first: only stop or ponderhit would release it otherwise, so joining
+// would never return.
+void UciEngine::stopSearch() {
+    if (!searchThread.joinable()) return;
+    releaseBestMove();
+    search.stop();
+    searchThread.join();
+}
+
+void UciEngine::releaseBestMove() {
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex);
+        holdBestMove = false;
+    }
+    released.notify_all();
+}
+
+void UciEngine::reportIteration(const SearchResult& result) {
+    std::ostringstream line;
+    line << "info depth " << result.depth << " score " << formatScore(result.score)
+         << " nodes " << result.nodes << " nps " << result.nodes * 1000 / std::max<int64_t>(result.timeMs, 1)
+         << " hashfull " << tt.hashfull() << " time " << result.timeMs << " pv";
+    for (const Move& move : result.pv) line << " " << moveToString(move);
+    send(line.str());
+}
+
+// position [startpos | fen <six fields>] [moves <move>...]
+void UciEngine::setPosition(std::istringstream& args) {
+    std::string token, fen;
+    args >> token;
+    if (token == "startpos") {
+        fen = START_FEN;
+        args >> token;
+    } else if (token == "fen") {
+        while (args >> token && token != "moves") fen += token + " ";
+    } else {
+        return;
+    }
+
+    Game parsed;
+    if (!parsed.loadFEN(fen)) {
+        send("info string invalid fen: " + fen);
+        return;
+    }
+    // The undo stack keeps room for MAX_GAME_PLIES played moves
+    for (int played = 0; args >> token; played++) {
+        Move move = played < MAX_GAME_PLIES ? parseMove(parsed, token) : Move();
+        if (move == Move()) {
+            send("info string illegal move: " + token);
+            break;
+        }
+        parsed.makeMove(move);
+    }
+    game = parsed;
+}
+
+// setoption name <id> [value <x>]
+void UciEngine::setOption(std::istringstream& args) {
+    std::string token, name, value;
+    args >> token;
+    while (args >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+    while (args >> token) value += (value.empty() ? "" : " ") + token;
+
+    if (name == "Hash") {
+        size_t mb = std::strtoul(value.c_str(), nullptr, 10);
+        tt.resize(std::min(std::max<size_t>(mb, 1), MAX_HASH_MB));
+        return;
+    }
+    if (name == "OwnBook") {
+        ownBook = (value == "true");
+        return;
+    }
+    if (name == "BookFile") {
+        book.reset(value.empty() || value == "<empty>" ? nullptr : new OpeningBook(value));
+        if (book && !book->isOpen()) {
+            send("info string cannot read book " + value);
+            book.reset();
+        }
+        return;
+    }
+    if (name == "BitbasePath") {
+        search.setBitbases(nullptr);
+        bitbases.reset(new Bitbases);
+        if (!value.empty() && value != "<empty>") {
+            int loaded = bitbases->load(value);
+            send("info string " + std::to_string(loaded) + " bitbases loaded from " + value);
+            if (loaded) search.setBitbases(bitbases.get());
+        }
+        return;
+    }
+    if (name == "Ponder") {
+        // Pondering needs nothing set up: "go ponder" says when
+        return;
+    }
+    if (name == "Threads") {
+        search.setThreads(std::min(std::max(std::atoi(value.c_str()), 1), MAX_THREADS));
+        return;
+    }
+    for (const FeatureOption& option : FEATURE_OPTIONS) {
+        if (name == option.option) {
+            SearchFeatures features = search.getFeatures();
+            features.set(option.feature, value == "true");
+            search.setFeatures(features);
+            return;
+        }
+    }
+    send("info string unknown option: " + name);
+}
+
+void UciEngine::go(std::istringstream& args) {
+    SearchLimits limits;
+    std::string token;
+    while (args >> token) {
+        if (token == "depth") args >> limits.depth;
+        else if (token == "nodes") args >> limits.nodes;
+        else if (token == "movetime") args >> limits.movetime;
+        else if (token == "wtime") args >> limits.time[toIndex(Color::WHITE)];
+        else if (token == "btime") args >> limits.time[toIndex(Color::BLACK)];
+        else if (token == "winc") args >> limits.increment[toIndex(Color::WHITE)];
+        else if (token == "binc") args >> limits.increment[toIndex(Color::BLACK)];
+        else if (token == "movestogo") args >> limits.movesToGo;
+        else if (token == "infinite") limits.infinite = true;
+        else if (token == "ponder") limits.ponder = true;
+    }
+
+    // A book move needs no search, unless the GUI wants one to analyse
+    if (ownBook && book && !limits.infinite && !limits.ponder) {
+        Move move = book->pick(game, bookRandom.next());
+        if (move != Move()) {
+            send("info string book move");
+            send("bestmove " + moveToString(move));
+            return;
+        }
+    }
+
+    // Armed here, so a stop or ponderhit read before the search thread
+    // reaches think() still counts
+    search.arm(limits.ponder);
+    holdBestMove = limits.infinite || limits.ponder;
+    searchThread = std::thread([this, limits] {
+        SearchResult result = search.think(game, limits);
+
+        {
+            std::unique_lock<std::mutex> lock(releaseMutex);
+            released.wait(lock, [this] { return !holdBestMove; });
+        }
+
+        std::string line = "bestmove " + (result.bestMove == Move() ? std::string("0000") : moveToString(result.bestMove));
+        if (result.pv.size() > 1) line += " ponder " + moveToString(result.pv[1]);
+        send(line);
+    });
+}
+
+void UciEngine::loop() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream args(line);
+        std::string command;
+        args >> command;
+
+        if (command == "uci") {
+            std::ostringstream out;
+            out << "id name Chess\n"
+                << "id author the Chess authors\n"
+                << "option name Hash type spin default " << DEFAULT_HASH_MB << " min 1 max " << MAX_HASH_MB << "\n"
+                << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << "\n"
+                << "option name Ponder type check default false\n"
+                << "option name OwnBook type check default false\n"
+                << "option name BookFile type string default <empty>\n"
+                << "option name BitbasePath type string default <empty>\n";
+            for (const FeatureOption& option : FEATURE_OPTIONS) {
+                out << "option name " << option.option << " type check default true\n";
+            }
+            out << "uciok";
+            send(out.str());
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "ucinewgame") {
+            stopSearch();
+            tt.clear();
+        } else if (command == "position") {
+            stopSearch();
+            setPosition(args);
+        } else if (command == "setoption") {
+            stopSearch();
+            setOption(args);
+        } else if (command == "go") {
+            stopSearch();
+            go(args);
+        } else if (command == "stop") {
+            stopSearch();
+        } else if (command == "ponderhit") {
+            search.ponderhit();
+            releaseBestMove();
+        } else if (command == "quit") {
+            break;
+        } else if (!command.empty()) {
+            send("info string unknown command: " + command);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    UciEngine engine;
+    engine.loop();
+    return 0;
+}
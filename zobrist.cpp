@@ -0,0 +1,37 @@
+#include "zobrist.h"
+#include "prng.h"
+
+#include <mutex>
+
+namespace Zobrist {
+
+uint64_t psq[12][64];
+uint64_t enPassant[8];
+uint64_t castling[16];
+uint64_t side;
+
+void init() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        PRNG rng(1070372);
+        for (auto& piece : psq) {
+            for (uint64_t& key : piece) key = rng.next();
+        }
+        for (uint64_t& key : enPassant) key = rng.next();
+
+        // Combined rights get the XOR of their single-right keys, so clearing
+        // one right is a single XOR whatever else is still set
+        uint64_t single[4];
+        for (uint64_t& key : single) key = rng.next();
+        for (int rights = 0; rights < 16; rights++) {
+            castling[rights] = 0;
+            for (int bit = 0; bit < 4; bit++) {
+                if (rights & (1 << bit)) castling[rights] ^= single[bit];
+            }
+        }
+
+        side = rng.next();
+    });
+}
+
+} // namespace Zobrist
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "types.h"
+
+// ============= ZOBRIST KEYS =============
+
+namespace Zobrist {
+
+extern uint64_t psq[12][64];
+extern uint64_t enPassant[8];
+extern uint64_t castling[16];
+extern uint64_t side;
+
+// Fill the key tables once (safe to call repeatedly and from any thread)
+void init();
+
+} // namespace Zobrist